@@ -19,6 +19,9 @@
 #include <SDL3/SDL.h>
 #include <stdbool.h>
 
+#include "frame_arena.h"
+#include "render_batch.h"
+
 typedef struct {
     // Window size in pixels.
     int window_w;
@@ -35,11 +38,40 @@ typedef struct {
     // Owned SDL objects.
     SDL_Window* window;
     SDL_Renderer* renderer;
+
+    // Reusable rect batch for per-frame drawing (see render_batch.h).
+    RenderBatch rect_batch;
+
+    // Scratch memory for draw code, reset by App_BeginFrame (see frame_arena.h).
+    FrameArena frame_arena;
+
+    // Heap allocations made by rect_batch + frame_arena, tracked per frame.
+    // Once buffers have grown to fit, frames_with_allocs stops increasing.
+    uint64_t frames;
+    uint64_t frames_with_allocs;
+    uint64_t last_alloc_frame;
+    uint64_t last_frame_allocs;
+    uint64_t alloc_mark;
+
+    // Pre-rendered grid lines (normal + dimmed end-state), owned by render.c.
+    // Built on first use for the size recorded below; Render_InvalidateGridCache
+    // drops them after a resize or render-target loss.
+    SDL_Texture* grid_tex;
+    SDL_Texture* grid_tex_dim;
+    int grid_tex_w;
+    int grid_tex_h;
+    int grid_tex_cols;
+    int grid_tex_rows;
+    bool grid_tex_failed;   // texture targets unavailable: draw lines directly
 } App;
 
 // Creates the SDL window/renderer and computes grid→pixel scaling.
 // Returns false on failure and logs the SDL error.
 bool App_Init(App* app, int window_w, int window_h, int grid_w, int grid_h);
 
-// Destroys SDL resources created by App_Init.
+// Starts a render frame: resets per-frame scratch and updates the
+// allocation counters for the frame that just finished.
+void App_BeginFrame(App* app);
+
+// Destroys SDL resources created by App_Init (plus per-frame buffers / grid cache).
 void App_Shutdown(App* app);
@@ -7,12 +7,10 @@
  *
  * Design notes:
  * - Spawning avoids placing an apple inside the snake.
- * - When the board is nearly full, random sampling becomes inefficient, so the
- *   implementation falls back to a deterministic scan.
- *   That scan has two benefits:
- *     1) It guarantees progress.
- *     2) It makes “you win” states behave predictably when the snake fills the
- *        board.
+ * - The apple is drawn uniformly from the snake’s free-cell set, so a spawn is
+ *   O(1) even when the board is nearly full, and always makes progress.
+ * - When no free cell is left (the snake fills the board) the apple keeps its
+ *   position, which keeps “you win” states predictable.
  */
 
 #include <stdbool.h>
@@ -4,6 +4,8 @@
 #include <stdint.h>
 
 #include "apple.h"
+#include "cycle_file.h"
+#include "histogram.h"
 #include "snake.h"
 
 /*
@@ -14,10 +16,32 @@
  * Strategy (high level):
  *  1) Follow a Hamiltonian cycle over the whole board.
  *  2) The cycle is precomputed and stored as a sequence of directions.
+ *  3) BOT_MODE_CYCLE takes single-step shortcuts ahead along the cycle.
+ *     BOT_MODE_PLAN takes shortest paths to the apple while the board is
+ *     mostly empty, each one only if the snake can still reach its tail
+ *     afterwards. It then lays the body onto the cycle and follows the
+ *     cycle strictly, rewired toward each apple as in 4).
+ *  4) BOT_MODE_REPAIR keeps the cycle shortcuts but also rewires the cycle
+ *     itself in the free stretch ahead of the head: a loop before the apple
+ *     is unspliced at one 2x2 block and spliced back in after it at another,
+ *     so the apple comes up sooner along the cycle.
  *
  * Bot mode is meant to be embedded in-game and launched via the GUI.
  */
 
+typedef enum BotMode {
+  BOT_MODE_CYCLE = 0,
+  BOT_MODE_PLAN = 1,
+  BOT_MODE_REPAIR = 2
+} BotMode;
+
+// Default per-search time budget for BOT_MODE_PLAN.
+#define BOT_PLAN_BUDGET_US 1000
+
+// Lookahead depth (ticks) used under a per-tick budget, and its upper bound.
+#define BOT_LOOKAHEAD_DEPTH 8
+#define BOT_LOOKAHEAD_MAX_DEPTH 16
+
 typedef struct BotTuning {
   // Scoring weights for shortcut selection (safety checks remain enforced).
   double k_progress;
@@ -28,8 +52,51 @@ typedef struct BotTuning {
   double aggression_scale;
   int loop_window;
   int max_skip_cap;
+
+  // Not part of any preset; apply_preset leaves these alone.
+  BotMode mode;
+  int plan_budget_us; // <= 0 selects BOT_PLAN_BUDGET_US
+  // Per-tick decision budget. 0 keeps the one-step greedy choice; otherwise
+  // the safe candidates are compared by a lookahead of up to lookahead_depth
+  // ticks until the budget runs out.
+  int tick_budget_us;
+  int lookahead_depth; // <= 0 selects BOT_LOOKAHEAD_DEPTH
 } BotTuning;
 
+// BOT_MODE_PLAN phases (see plan_next_dir in bot.c).
+typedef enum PlanPhase {
+  PLAN_FREE = 0, // shortest paths to the apple, body off the cycle
+  PLAN_SETTLE,   // following the cycle strictly until the body lies on it
+  PLAN_CYCLE     // body contiguous on the cycle; repaired and followed
+} PlanPhase;
+
+// BOT_MODE_PLAN state. The search buffers are n_cells long and allocated with
+// the bot, so planning never allocates.
+typedef struct BotPlan {
+  int *dist;      // BFS depth per cell (valid where seen == stamp)
+  uint32_t *seen; // visit stamps, so no per-search clear
+  uint32_t stamp;
+  int *bfs;      // BFS queue
+  int *queue;    // simulated body ring (n_cells + 1)
+  uint8_t *from; // Dir taken into each reached cell
+  int *seg;      // segment index per occupied cell (valid while occupied)
+  uint8_t *occ;  // simulated occupancy, all zero between plans
+
+  // The committed path: dirs[step..len) lead the head to apple_cell.
+  Dir *dirs;
+  int len, step;
+  int apple_cell;
+  int expect_cell; // head cell the next step starts from
+
+  PlanPhase phase;
+  int run;   // strict cycle moves made in PLAN_SETTLE
+  int stuck; // searches in a row that found no safe path
+
+  // Paths taken, tail-chasing moves, and ticks where no move kept the tail
+  // in reach (the cycle logic moved instead).
+  uint64_t n_paths, n_chase, n_failed;
+} BotPlan;
+
 typedef struct Bot {
   int grid_w, grid_h;
   int n_cells;
@@ -50,17 +117,45 @@ typedef struct Bot {
 
   // Full cycle as a sequence of directions, starting at top-right.
   Dir *cycle_dirs;
+  // BOT_MODE_REPAIR rewrites cycle_next_dir, cycle_index, pos_of_idx and
+  // cycle_dirs in place, so they describe the current cycle rather than the
+  // loaded one. Scratch for that, plus the apple cell last repaired toward
+  // (-1 after Bot_Reset):
+  IVec2 *repair_pos;
+  int *repair_visit;
+  int *repair_marks;
+  int repair_apple;
+  uint64_t n_repairs;
+  // Cycle index of the head as of the last tick; -1 (Bot_Reset) forces the
+  // occupancy mirror below to be rebuilt.
   int cycle_pos;
 
-  bool cycle_wrap;
+  // Snake occupancy in cycle order, one bit per cycle index, so corridor
+  // checks scan 64 cells per word. Kept in step from the head push / tail
+  // pop between ticks.
+  uint64_t *occ_bits;
+  int occ_head_cell, occ_tail_cell, occ_len;
 
-  // Occupancy by cycle index for fast local safety checks.
-  uint8_t *occupied_idx;
+  bool cycle_wrap;
 
   // Loop avoidance: last tick a cycle index was visited by the head.
   int *last_visit_idx;
   uint32_t tick;
 
+  BotPlan plan;
+
+  // Tick budget stats (only kept while tuning.tick_budget_us > 0): ticks
+  // decided and their total / worst wall time, ticks that ran the lookahead,
+  // the sum of the depths they completed, and how many ran out of budget
+  // before reaching lookahead_depth.
+  uint64_t n_decisions, decide_ns_total, decide_ns_max;
+  uint64_t n_lookahead, lookahead_depth_sum, n_budget_exhausted;
+
+  // Time every decision even without a tick budget (set after init). Timed
+  // decisions also go into decide_time.
+  bool time_decisions;
+  Histogram decide_time;
+
   // Debug: log when a shortcut is taken.
   bool debug_shortcuts;
 
@@ -77,18 +172,23 @@ typedef enum Preset {
 // Initialize with a default built-in Hamiltonian cycle.
 bool Bot_Init(Bot *b, int grid_w, int grid_h);
 
-// Optional: load a custom cycle from a ".cycle" container file.
+// Initialize directly from a decoded .cycle file (see cycle_file.h); the
+// board size comes from its metadata. No built-in cycle is generated, so any
+// board size the file supports works.
+bool Bot_InitFromCycle(Bot *b, const CycleFile *cf);
+
+// Optional: replace the cycle with one from a ".cycle" container file, text
+// (SNAKECYCLE 1) or binary (SNAKECYCLE 2). Its dimensions must match the bot.
 // The loader refuses any non-.cycle path.
-//
-// Format:
-//   SNAKECYCLE 1
-//   key=value (optional, e.g. width=40)
-//   DATA
-//   U/D/L/R direction letters (whitespace ignored), row-major
 bool Bot_LoadCycleFromFile(Bot *b, const char *path);
 
 void Bot_Destroy(Bot *b);
 
+// Call when a new game starts on the same board. The next Bot_OnTick rebuilds
+// the bot's occupancy mirror from the snake (O(n)); every other tick only
+// applies the head/tail change (O(1)).
+void Bot_Reset(Bot *b);
+
 // Called once per simulation tick (right before Snake_Tick). This function
 // queues at most one direction change into the snake.
 void Bot_OnTick(Bot *b, Snake *s, const Apple *a);
@@ -97,5 +197,15 @@ void Bot_OnTick(Bot *b, Snake *s, const Apple *a);
 void apply_preset(Preset p, BotTuning *t);
 bool preset_matches_current(Preset p, const BotTuning *t, double epsilon);
 
+// Map a CLI preset name ("safe", "aggressive", "greedy", "chaotic").
+bool preset_from_name(const char *name, Preset *out);
+
+// Shared CLI parsing for --bot-preset, --bot-mode (cycle|plan|repair),
+// --bot-plan-budget-us, --bot-tick-budget-us, --bot-lookahead and the
+// --bot-k-* / tuning flags. Returns the number of
+// extra argv entries consumed (1), 0 if argv[i] is not a tuning flag, or -1 if
+// the preset or mode name is unknown.
+int parse_tuning_arg(int argc, char **argv, int i, BotTuning *t);
+
 // Apply tuning values (clamped for safety).
 void Bot_SetTuning(Bot *b, const BotTuning *t);
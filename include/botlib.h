@@ -4,9 +4,24 @@
 // Hamiltonian cycles.
 //
 // Design goals:
-//   - No heap allocations (easy ctypes use)
+//   - *_ws variants never allocate: all scratch comes from the caller
+//     (easy ctypes use)
 //   - Plain C ABI
 //   - Caller provides output/error buffers
+//
+// Workspaces:
+//   Each entry point has a *_ws twin that takes a caller-provided workspace
+//   (size it with snakebot_workspace_size; 1024x1024 needs ~10 MiB) and
+//   never allocates. The plain entry points are conveniences: they malloc
+//   that workspace for the duration of the call and free it before
+//   returning. Use the *_ws variants where hidden heap use matters.
+//
+// Threading:
+//   Every entry point is reentrant: no global or static mutable state.
+//   Concurrent calls are safe as long as they don't share out/err/workspace
+//   buffers.
+//   snakebot_build_cycle_files_batch runs its own worker threads and joins
+//   them before returning.
 
 #ifdef __cplusplus
 extern "C" {
@@ -25,6 +40,11 @@ extern "C" {
 // Returns a static version string.
 SNAKEBOT_API const char* snakebot_version(void);
 
+// Bytes of workspace the *_ws entry points need for a w×h board.
+// Returns -1 if w/h are non-positive or w*h does not fit in an int.
+// A workspace sized for a board also fits every smaller board.
+SNAKEBOT_API long long snakebot_workspace_size(int w, int h);
+
 // Generate a Hamiltonian cycle for the grid.
 //
 // Parameters:
@@ -42,6 +62,12 @@ SNAKEBOT_API int snakebot_generate_cycle(
     char* out, int out_len,
     char* err, int err_len);
 
+SNAKEBOT_API int snakebot_generate_cycle_ws(
+    int w, int h,
+    char* out, int out_len,
+    void* workspace, long long workspace_len,
+    char* err, int err_len);
+
 // Validate a cycle string.
 //
 // Parameters:
@@ -57,6 +83,12 @@ SNAKEBOT_API int snakebot_validate_cycle(
     const char* cycle,
     char* err, int err_len);
 
+SNAKEBOT_API int snakebot_validate_cycle_ws(
+    int w, int h,
+    const char* cycle,
+    void* workspace, long long workspace_len,
+    char* err, int err_len);
+
 // Build a complete .cycle container file as ASCII text (null-terminated).
 //
 // The file includes metadata (dimensions + seed) so the game can load it
@@ -84,6 +116,92 @@ SNAKEBOT_API int snakebot_build_cycle_file_ex(
     char* out, int out_len,
     char* err, int err_len);
 
+SNAKEBOT_API int snakebot_build_cycle_file_ex_ws(
+    int w, int h,
+    int window_w, int window_h,
+    unsigned int seed,
+    const char* cycle_type,
+    char* out, int out_len,
+    void* workspace, long long workspace_len,
+    char* err, int err_len);
+
+// Upper bound on the length of a .cycle file from snakebot_build_cycle_file_ex
+// for a w×h board, including the terminating null. Returns -1 on bad w/h.
+SNAKEBOT_API long long snakebot_cycle_file_max_len(int w, int h);
+
+// Build .cycle files for seeds seed_first .. seed_first+count-1 on a pool of
+// worker threads.
+//
+// Parameters:
+//   threads        Worker count; <= 0 uses one per CPU. Also capped by count
+//                  and by how many workspaces fit in workspace_len.
+//   out            count slots of out_stride bytes each. Seed i's file is
+//                  written null-terminated at out + i*out_stride; if that seed
+//                  fails, its slot holds the error message instead.
+//   out_stride     Bytes per slot, e.g. snakebot_cycle_file_max_len(w, h).
+//   out_rc         count ints; receives each seed's return code (0 = ok).
+//   workspace      threads * snakebot_workspace_size(w, h) bytes for full
+//                  parallelism.
+//
+// Returns:
+//   0 if every seed succeeded, non-zero otherwise (err names the first
+//   failure).
+SNAKEBOT_API int snakebot_build_cycle_files_batch(
+    int w, int h,
+    int window_w, int window_h,
+    unsigned int seed_first, int count,
+    const char* cycle_type,
+    int threads,
+    char* out, long long out_stride,
+    int* out_rc,
+    void* workspace, long long workspace_len,
+    char* err, int err_len);
+
+// Streaming .cycle output.
+//
+// These write the container incrementally instead of into one caller buffer:
+// the header and then each row go through a small fixed chunk to a callback
+// or file, so output memory stays bounded for any board size (the
+// generator's own workspace is still w*h-sized).
+//
+// format is SNAKEBOT_FORMAT_TEXT (SNAKECYCLE 1) or SNAKEBOT_FORMAT_BINARY
+// (SNAKECYCLE 2). The write callback returns 0 on success; any other value
+// aborts the write.
+#define SNAKEBOT_FORMAT_TEXT 1
+#define SNAKEBOT_FORMAT_BINARY 2
+
+typedef int (*snakebot_write_fn)(void* user, const void* data, int len);
+
+SNAKEBOT_API int snakebot_write_cycle_file_ws(
+    int w, int h,
+    int window_w, int window_h,
+    unsigned int seed,
+    const char* cycle_type,
+    int format,
+    snakebot_write_fn write, void* user,
+    void* workspace, long long workspace_len,
+    char* err, int err_len);
+
+// Write straight to path. A partially written file is removed on failure.
+SNAKEBOT_API int snakebot_save_cycle_file(
+    const char* path,
+    int w, int h,
+    int window_w, int window_h,
+    unsigned int seed,
+    const char* cycle_type,
+    int format,
+    char* err, int err_len);
+
+SNAKEBOT_API int snakebot_save_cycle_file_ws(
+    const char* path,
+    int w, int h,
+    int window_w, int window_h,
+    unsigned int seed,
+    const char* cycle_type,
+    int format,
+    void* workspace, long long workspace_len,
+    char* err, int err_len);
+
 // Validate a .cycle container text. If valid, writes detected width/height
 // into out_w/out_h when those pointers are non-null.
 SNAKEBOT_API int snakebot_validate_cycle_file(
@@ -92,6 +210,62 @@ SNAKEBOT_API int snakebot_validate_cycle_file(
     int* out_h,
     char* err, int err_len);
 
+SNAKEBOT_API int snakebot_validate_cycle_file_ws(
+    const char* cycle_file_text,
+    int* out_w,
+    int* out_h,
+    void* workspace, long long workspace_len,
+    char* err, int err_len);
+
+// Binary .cycle container (SNAKECYCLE 2): fixed 64-byte header plus 2 bits
+// per cell, see cycle_file.h for the layout. The game memory-maps these.
+//
+// Exact byte size of a binary file for a w×h board, or -1 on bad w/h.
+SNAKEBOT_API long long snakebot_cycle_file_bin_size(int w, int h);
+
+// Same inputs as snakebot_build_cycle_file_ex; writes exactly
+// snakebot_cycle_file_bin_size(w, h) bytes (not null-terminated).
+SNAKEBOT_API int snakebot_build_cycle_file_bin(
+    int w, int h,
+    int window_w, int window_h,
+    unsigned int seed,
+    const char* cycle_type,
+    void* out, long long out_len,
+    char* err, int err_len);
+
+SNAKEBOT_API int snakebot_build_cycle_file_bin_ws(
+    int w, int h,
+    int window_w, int window_h,
+    unsigned int seed,
+    const char* cycle_type,
+    void* out, long long out_len,
+    void* workspace, long long workspace_len,
+    char* err, int err_len);
+
+// Validate len bytes of a .cycle container in either format (binary data may
+// contain NULs, so it can't go through snakebot_validate_cycle_file). Same
+// outputs as snakebot_validate_cycle_file.
+SNAKEBOT_API int snakebot_validate_cycle_file_bin(
+    const void* data, long long len,
+    int* out_w,
+    int* out_h,
+    char* err, int err_len);
+
+SNAKEBOT_API int snakebot_validate_cycle_file_bin_ws(
+    const void* data, long long len,
+    int* out_w,
+    int* out_h,
+    void* workspace, long long workspace_len,
+    char* err, int err_len);
+
+// Validate a .cycle file on disk (either format) without the caller reading
+// it; the file is memory-mapped.
+SNAKEBOT_API int snakebot_validate_cycle_file_path(
+    const char* path,
+    int* out_w,
+    int* out_h,
+    char* err, int err_len);
+
 #ifdef __cplusplus
 }
 #endif
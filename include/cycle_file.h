@@ -0,0 +1,103 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * cycle_file.h
+ *
+ * On-disk .cycle containers shared by the game, snake_sim and botlib.
+ *
+ * Text (SNAKECYCLE 1): key=value metadata, DATA, then one U/D/L/R letter per
+ * cell in row-major order.
+ *
+ * Binary (SNAKECYCLE 2): a fixed 64-byte little-endian header followed by the
+ * directions packed 2 bits per cell (cell i lives in byte i/4 at bit
+ * 2*(i%4)), about 4x smaller than text and usable straight from a mapping:
+ *
+ *   off  size  field
+ *     0    16  magic "SNAKECYCLE 2\n" padded with NULs
+ *    16     4  width
+ *    20     4  height
+ *    24     4  window_w
+ *    28     4  window_h
+ *    32     4  seed
+ *    36     4  flags (bit 0: wrap)
+ *    40     4  data offset (64)
+ *    44     4  reserved (0)
+ *    48    16  cycle type name, NUL padded
+ *
+ * Direction codes match Dir: 0 up, 1 down, 2 left, 3 right.
+ *
+ * Every reader (game, snake_sim, botlib's validators) goes through
+ * CycleFile_ParseMeta / CycleFile_DecodeDirs, so the formats are defined in
+ * one place.
+ */
+
+#define CYCLE_TEXT_MAGIC "SNAKECYCLE 1"
+#define CYCLE_BIN_MAGIC "SNAKECYCLE 2\n"
+#define CYCLE_BIN_HEADER_SIZE 64
+#define CYCLE_BIN_FLAG_WRAP 1u
+
+typedef struct CycleFileMeta {
+  int width, height;
+  int window_w, window_h; // -1 when absent
+  unsigned int seed;      // 0 when absent
+  int wrap;               // -1 when absent
+  char cycle_type[16];
+} CycleFileMeta;
+
+// Read-only view of a whole file (memory-mapped when the platform allows).
+typedef struct CycleFileMap {
+  const uint8_t *data;
+  size_t size;
+  void *handle; // platform mapping handle
+} CycleFileMap;
+
+bool CycleFile_Map(CycleFileMap *m, const char *path);
+void CycleFile_Unmap(CycleFileMap *m);
+
+// A decoded container: metadata plus width*height direction codes (Dir
+// order), row-major.
+typedef struct CycleFile {
+  CycleFileMeta meta;
+  uint8_t *dirs;
+} CycleFile;
+
+// Maps path once, parses the metadata and decodes every direction in a single
+// pass. Refuses any path not ending in ".cycle". Free with CycleFile_Free.
+bool CycleFile_Load(CycleFile *cf, const char *path, char *err, int err_len);
+void CycleFile_Free(CycleFile *cf);
+
+// The two halves of CycleFile_Load for callers that own their buffers
+// (botlib). data need not be null-terminated.
+//
+// ParseMeta accepts either format, requires width/height and DATA (text),
+// and reports where the direction data starts. It also checks the data is
+// long enough for width*height cells, so sizing buffers from meta is safe.
+// Absent optional keys keep the defaults documented on CycleFileMeta.
+bool CycleFile_ParseMeta(const void *data, size_t size, CycleFileMeta *meta,
+                         size_t *data_off, char *err, int err_len);
+
+// Writes meta->width*meta->height codes into dirs. Text data may contain
+// whitespace and lowercase letters; anything else, or the wrong number of
+// letters, is an error.
+bool CycleFile_DecodeDirs(const void *data, size_t size,
+                          const CycleFileMeta *meta, size_t data_off,
+                          uint8_t *dirs, char *err, int err_len);
+
+// Byte size of a binary container for a w x h board, or -1 if invalid.
+long long CycleFile_BinSize(int w, int h);
+
+// Writes the CYCLE_BIN_HEADER_SIZE header bytes for meta.
+void CycleFile_WriteBinHeader(uint8_t *out, const CycleFileMeta *meta);
+
+static inline int CycleFile_GetCode(const uint8_t *packed, int i) {
+  return (packed[i >> 2] >> ((i & 3) * 2)) & 3;
+}
+
+// packed must start zeroed.
+static inline void CycleFile_PutCode(uint8_t *packed, int i, int code) {
+  packed[i >> 2] |= (uint8_t)((code & 3) << ((i & 3) * 2));
+}
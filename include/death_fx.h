@@ -59,4 +59,5 @@ void DeathFx_Start(DeathFx* fx, bool interp_mode, float death_alpha, uint64_t no
 
 // Draws the effect for the current frame and advances internal timers.
 // When finished, fx->finished becomes true.
-void DeathFx_RenderAndAdvance(DeathFx* fx, const App* app, const Snake* snake, uint64_t now_ns);
+// Scratch comes from app->frame_arena; the whole snake is one geometry call.
+void DeathFx_RenderAndAdvance(DeathFx* fx, App* app, const Snake* snake, uint64_t now_ns);
@@ -23,6 +23,10 @@ typedef struct EventsFrame {
     bool toggle_interp;   // bound to P
     bool continue_game;   // bound to L
 
+    // Window pixel size changed or the renderer lost its targets/device:
+    // cached render textures must be rebuilt.
+    bool render_reset;
+
     // One frame can produce multiple direction inputs.
     // The snake module decides how many of these to accept.
     int dir_count;
@@ -12,13 +12,44 @@
  * - Rendering can run very fast (up to RENDER_CAP_HZ) for smoothness.
  * - Simulation steps are limited by tick_hz and may ramp with score.
  *
- * This module keeps the window title up to date without doing extra work every frame: it recomputes fps/tps about once per second, but rewrites the title every call so end-state titles don’t get clobbered by stale text.
+ * Averages hide stalls, so it also keeps duration histograms (see
+ * histogram.h) for the stages of a frame and a tick, with p50/p95/p99/max
+ * available through Fps_GetPercentiles and logged by Fps_LogHistograms.
+ *
+ * The window title is kept current without work on every frame. fps/tps
+ * are recomputed about once per second. The title is reformatted only when
+ * its inputs (state, score, fps/tps, interp) change. It is handed to SDL
+ * only when the text changes: each SDL_SetWindowTitle is a round-trip to
+ * the window system.
  */
 
 #include <stdint.h>
 #include <stdbool.h>
 #include <SDL3/SDL.h>
 
+#include "histogram.h"
+
+// Score-only title changes are pushed at most this often (a fast bot scores
+// many times a second); state changes are pushed immediately.
+#define FPS_TITLE_MIN_INTERVAL_NS 250000000ull
+
+typedef enum FpsHist {
+    FPS_HIST_FRAME = 0,   // start-to-start frame time
+    FPS_HIST_RENDER,      // building the frame, up to present
+    FPS_HIST_PRESENT,     // the present call itself
+    FPS_HIST_SIM,         // one simulation tick (sim thread)
+    FPS_HIST_BOT,         // one bot decision (sim thread)
+    FPS_HIST_COUNT
+} FpsHist;
+
+typedef struct FpsPercentiles {
+    uint64_t count;
+    uint64_t p50_ns;
+    uint64_t p95_ns;
+    uint64_t p99_ns;
+    uint64_t max_ns;
+} FpsPercentiles;
+
 typedef struct FpsCounter {
     uint64_t last_sample_ns;
 
@@ -27,14 +58,47 @@ typedef struct FpsCounter {
 
     double fps;
     double tps;
+
+    Histogram hist[FPS_HIST_COUNT];
+
+    // Window title cache: the text last handed to SDL and the inputs it was
+    // formatted from (title_kind -1 until the first push).
+    char title[260];
+    int title_kind;
+    int title_score;
+    double title_fps;
+    double title_tps;
+    bool title_interp;
+    uint64_t title_pushed_ns;
+
+    uint64_t title_updates;  // SDL_SetWindowTitle calls
+    uint64_t title_skipped;  // title calls that changed nothing visible
 } FpsCounter;
 
 void Fps_Init(FpsCounter* c);
 void Fps_OnFrame(FpsCounter* c);
 void Fps_OnTick(FpsCounter* c);
+// Counts n ticks at once (ticks run on the sim thread, see sim_thread.h).
+void Fps_AddTicks(FpsCounter* c, int n);
+
+// Render-thread stages are recorded as they happen. Histograms filled on
+// another thread (sim ticks, bot decisions, the frame pacer) are merged in
+// once that thread is done with them.
+void Fps_Record(FpsCounter* c, FpsHist which, uint64_t ns);
+void Fps_MergeHistogram(FpsCounter* c, FpsHist which, const Histogram* h);
 
-// Always writes the title each call.
+// All zero when nothing was recorded.
+FpsPercentiles Fps_GetPercentiles(const FpsCounter* c, FpsHist which);
+
+// One log line per non-empty histogram.
+void Fps_LogHistograms(const FpsCounter* c);
+
+// Call every frame; the title is only rewritten when it changed.
 // FPS/TPS are only recomputed about once per second.
 void Fps_UpdateWindowTitle(FpsCounter* c, SDL_Window* window,
                            bool interp_on, int score,
                            bool game_over, bool you_win);
+
+// End-state title (no FPS text), cached the same way.
+void Fps_SetEndTitle(FpsCounter* c, SDL_Window* window,
+                     bool you_win, int score);
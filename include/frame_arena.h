@@ -0,0 +1,45 @@
+#pragma once
+
+/*
+ * frame_arena.h
+ *
+ * Per-frame scratch memory for draw code.
+ *
+ * Allocations are bump-pointer carves out of one persistent block and are all
+ * released together by FrameArena_Reset at the start of the next frame.
+ * The block only grows: if a frame asks for more than fits, the excess is
+ * served from temporary heap blocks and the base block is resized to the
+ * frame's peak on the next reset. After a frame or two at a given snake
+ * length, frames stop touching the heap entirely (see heap_allocs).
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+typedef struct FrameArenaBlock FrameArenaBlock;
+
+typedef struct FrameArena {
+    unsigned char* base;
+    size_t cap;
+    size_t used;
+
+    // Bytes requested since the last reset, including overflow.
+    size_t peak;
+
+    // Temporary blocks for requests that did not fit this frame.
+    FrameArenaBlock* overflow;
+
+    // Lifetime count of heap allocations made by the arena.
+    uint64_t heap_allocs;
+} FrameArena;
+
+// Starts a new frame: invalidates every pointer handed out since the last
+// reset and grows the base block if the previous frame overflowed it.
+void FrameArena_Reset(FrameArena* a);
+
+// Returns `size` bytes aligned for any scalar type, valid until the next
+// reset. Returns NULL only if the heap is exhausted.
+void* FrameArena_Alloc(FrameArena* a, size_t size);
+
+// Frees all storage.
+void FrameArena_Destroy(FrameArena* a);
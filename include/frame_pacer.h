@@ -0,0 +1,45 @@
+#pragma once
+
+/*
+ * frame_pacer.h
+ *
+ * Render frame cap with low jitter.
+ *
+ * A plain SDL_DelayNS for the rest of the frame wakes up late by up to the
+ * OS scheduler quantum, which shows as uneven frame times at 240 Hz. The
+ * pacer sleeps only until spin_ns before the deadline and spin-waits on
+ * SDL_GetTicksNS for the rest.
+ *
+ * With VSync on (and supported by the renderer), present already blocks until
+ * the display refresh, so the pacer doesn't wait at all.
+ *
+ * Either way it records the start-to-start time of every frame, which is the
+ * frame time the player actually sees.
+ */
+
+#include <SDL3/SDL.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "histogram.h"
+
+// Default spin window before each frame deadline.
+#define FRAME_PACER_SPIN_NS 500000ull
+
+typedef struct FramePacer {
+    uint64_t frame_ns;   // target frame length; 0 = uncapped
+    uint64_t spin_ns;
+    bool vsync;          // renderer VSync is on; no waiting here
+
+    uint64_t last_frame_start;  // 0 until the first FramePacer_Wait
+    Histogram frame_time;       // start-to-start frame times
+} FramePacer;
+
+// frame_ns is the target frame length. With want_vsync, VSync is requested
+// from renderer; if that fails the pacer falls back to its own cap.
+void FramePacer_Init(FramePacer* p, SDL_Renderer* renderer, uint64_t frame_ns,
+                     bool want_vsync);
+
+// Call once per frame after presenting, with the time the frame started.
+// Waits out the rest of the frame and records its full length.
+void FramePacer_Wait(FramePacer* p, uint64_t frame_start);
@@ -0,0 +1,46 @@
+#pragma once
+
+/*
+ * histogram.h
+ *
+ * Fixed-size latency histogram for durations in nanoseconds.
+ *
+ * Buckets are log-linear (HDR-style): exact below 32 ns, then every power of
+ * two is split into 32 equal sub-buckets, so any recorded value is known to
+ * within about 3% up to ~1100 s. Recording is O(1) and never allocates;
+ * percentiles walk the bucket array.
+ *
+ * A histogram is not thread-safe: record from one thread and read it from
+ * that thread (or after joining it).
+ */
+
+#include <stdint.h>
+
+#define HISTOGRAM_SUB_BITS 5
+#define HISTOGRAM_MAX_BITS 40
+#define HISTOGRAM_BUCKETS \
+    (((HISTOGRAM_MAX_BITS - HISTOGRAM_SUB_BITS) + 1) << HISTOGRAM_SUB_BITS)
+
+typedef struct Histogram {
+    // 64-bit: a max-speed sim records millions of ticks a second, so one
+    // bucket can pass 2^32 in a long run.
+    uint64_t counts[HISTOGRAM_BUCKETS];
+    uint64_t count;
+    uint64_t sum_ns;
+    uint64_t min_ns;
+    uint64_t max_ns;
+} Histogram;
+
+void Histogram_Reset(Histogram* h);
+void Histogram_Record(Histogram* h, uint64_t ns);
+
+// Adds every sample of src to dst (e.g. a worker thread's histogram after
+// joining it).
+void Histogram_Merge(Histogram* dst, const Histogram* src);
+
+// Smallest value v with at least p (0..1) of the samples <= v, reported as
+// the top of v's bucket (capped at the exact max). 0 for an empty histogram.
+uint64_t Histogram_Percentile(const Histogram* h, double p);
+
+// Mean of the recorded samples (exact, from the running sum).
+double Histogram_MeanNs(const Histogram* h);
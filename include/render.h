@@ -24,8 +24,15 @@ void Render_RectFilledPx(const App* app, float x, float y, float w, float h,
 void Render_QuadCenteredPx(const App* app, float cx, float cy, float w, float h, float angle_rad,
                            uint8_t r, uint8_t g, uint8_t b, uint8_t a);
 
-// Grid lines
-void Render_GridLines(const App* app);
+// Grid lines (cached texture, one blit per call)
+void Render_GridLines(App* app);
 
-// NEW: grid lines with configurable color + alpha
+// Dimmed grid used behind the win / game-over screens (cached texture)
+void Render_GridLinesDimmed(App* app);
+
+// Grid lines with configurable color + alpha, drawn line by line (uncached)
 void Render_GridLinesEx(const App* app, uint8_t r, uint8_t g, uint8_t b, uint8_t a);
+
+// Drops the cached grid textures; they are rebuilt on next use.
+// Call after a resize, grid change, or SDL render-target/device reset.
+void Render_InvalidateGridCache(App* app);
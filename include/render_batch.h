@@ -0,0 +1,40 @@
+#pragma once
+
+/*
+ * render_batch.h
+ *
+ * Collects filled rects so a run of same-colored shapes reaches SDL as one
+ * SDL_RenderFillRects call instead of one SetRenderDrawColor + RenderFillRect
+ * pair per shape. That keeps draw calls per frame constant no matter how many
+ * shapes are queued.
+ *
+ * Usage per frame:
+ *   RenderBatch_Reset(), queue rects with RenderBatch_Rect(), remember
+ *   b->count at color boundaries, then RenderBatch_FillRange() each run.
+ *
+ * Storage is grow-only and kept across frames, so steady-state frames do not
+ * allocate.
+ */
+
+#include <SDL3/SDL.h>
+#include <stdint.h>
+
+typedef struct RenderBatch {
+    SDL_FRect* rects;
+    int count;
+    int cap;
+    uint64_t heap_allocs;   // lifetime count of storage grows
+} RenderBatch;
+
+// Drops queued rects (keeps storage).
+void RenderBatch_Reset(RenderBatch* b);
+
+// Queues one rect. If growing the storage fails the rect is dropped.
+void RenderBatch_Rect(RenderBatch* b, float x, float y, float w, float h);
+
+// Submits rects [first, first + count) in one call using a single color.
+void RenderBatch_FillRange(SDL_Renderer* r, const RenderBatch* b, int first, int count,
+                           uint8_t cr, uint8_t cg, uint8_t cb);
+
+// Frees storage.
+void RenderBatch_Destroy(RenderBatch* b);
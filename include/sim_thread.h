@@ -0,0 +1,154 @@
+#pragma once
+
+/*
+ * sim_thread.h
+ *
+ * Runs the game simulation (snake + apple + optional bot) on its own thread,
+ * so a slow present never stalls ticks and a high bot TPS never starves
+ * rendering.
+ *
+ * Handoff:
+ * - After a tick the sim thread copies the state it renders from into an
+ *   immutable SimSnapshot and publishes it through a lock-free triple buffer:
+ *   it fills its back slot and swaps it with the middle one. The render thread
+ *   swaps its front slot with the middle one whenever a newer snapshot is
+ *   there. Neither side ever waits on the other.
+ * - A snapshot holds the snake pose of its tick and of the tick before
+ *   (Snake_Prev), so the renderer interpolates between the latest two ticks
+ *   from the one snapshot it holds.
+ * - Input travels the other way: directions through a small lock-free ring,
+ *   continue / quit as atomic flags.
+ *
+ * Scheduling:
+ * - Due ticks run in batches of at most batch_budget_ns (about one render
+ *   frame), judged by a running average of the measured per-tick cost.
+ *   Between batches the thread checks continue / quit and input again. Ticks
+ *   still due when a batch ends are deferred to the next one, and a backlog
+ *   past SIM_MAX_LAG_NS is dropped. Both are counted in SimTickStats.
+ * - A bot with bot_tps == 0 runs at max speed: ticks back to back, one batch
+ *   after another, with no tick clock at all.
+ *
+ * Once SimThread_Start has run, snake, apple and bot belong to the sim thread
+ * until SimThread_Stop returns.
+ */
+
+#include <SDL3/SDL.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "apple.h"
+#include "bot.h"
+#include "histogram.h"
+#include "snake.h"
+
+// Direction inputs buffered between sim ticks (power of two).
+#define SIM_INPUT_CAP 16
+
+// Default batch budget: one frame at 240 Hz.
+#define SIM_BATCH_BUDGET_NS 4166666ull
+
+// More than this behind, the clock skips ahead instead of replaying every
+// missed tick.
+#define SIM_MAX_LAG_NS 250000000ull
+
+// Written only by the sim thread; read it after SimThread_Stop.
+typedef struct SimTickStats {
+    uint64_t ticks;
+    uint64_t batches;        // batches that ran at least one tick
+    uint64_t max_batch;      // most ticks in one batch
+    uint64_t tick_ns_total;  // measured cost of all ticks
+    uint64_t tick_ns_max;
+    uint64_t deferred;       // due ticks pushed to a later batch (per push)
+    uint64_t dropped;        // due ticks skipped after falling too far behind
+    Histogram tick_time;     // per-tick cost, bot decision included
+} SimTickStats;
+
+typedef struct SimSnapshot {
+    // Snake as of this tick, laid out so Snake_Seg / Snake_Prev and the draw
+    // code work on it unchanged. Only the segments are copied: occ and the
+    // free-cell set are NULL here.
+    Snake snake;
+    IVec2* body;   // [max_len + 1], backing snake.seg
+
+    Apple apple;
+    int score;
+    int tick_hz;
+    bool game_over;
+    bool you_win;
+
+    uint32_t game;          // bumps on every new game
+    uint64_t tick_time_ns;  // when this tick was due (SDL_GetTicksNS clock)
+    uint64_t tick_ns;       // tick length at that point (0 at max speed)
+} SimSnapshot;
+
+typedef struct SimThread {
+    // Simulation state, owned by the sim thread while it runs.
+    int grid_w, grid_h;
+    Snake snake;
+    Apple apple;
+    Bot* bot;      // NULL for human play; not owned
+    int bot_tps;   // 0 with a bot: max speed
+    int score;
+    int max_score;
+    int tick_hz;
+    uint64_t tick_ns;       // 0 at max speed
+    uint64_t tick_time_ns;
+    bool game_over;
+    bool you_win;
+    uint32_t game;
+
+    // Triple buffer. back is the writer's slot, front the reader's; middle
+    // holds the third slot's index, plus SIM_SNAPSHOT_FRESH while the reader
+    // has not taken it yet.
+    SimSnapshot slots[3];
+    int back;
+    int front;
+    SDL_AtomicInt middle;
+    uint64_t last_publish_ns;
+
+    // Render thread -> sim thread.
+    Dir input[SIM_INPUT_CAP];
+    SDL_AtomicInt input_head;   // next slot the sim thread reads
+    SDL_AtomicInt input_tail;   // next slot the render thread writes
+    SDL_AtomicInt continue_req;
+    SDL_AtomicInt quit;
+
+    // Ticks run since the last SimThread_TakeTicks.
+    SDL_AtomicInt ticks;
+
+    // Scheduler. Set batch_budget_ns before SimThread_Start to change it.
+    uint64_t batch_budget_ns;
+    uint64_t tick_cost_ns;  // running average of the measured tick cost
+    SimTickStats stats;
+
+    SDL_Thread* thread;
+} SimThread;
+
+// Starts the first game and publishes its snapshot. bot may be NULL; with a
+// bot, bot_tps is the fixed tick rate (0 = max speed), otherwise the rate
+// ramps with score.
+// Draws from SDL_rand, as Game_Reset used to.
+bool SimThread_Init(SimThread* st, int grid_w, int grid_h, Bot* bot, int bot_tps);
+
+// Spawns the sim thread. Returns false (and logs) if the thread can't start.
+bool SimThread_Start(SimThread* st);
+
+// Asks the sim thread to exit and waits for it.
+void SimThread_Stop(SimThread* st);
+
+// Frees everything from SimThread_Init. Call after SimThread_Stop.
+void SimThread_Destroy(SimThread* st);
+
+// Render thread: the newest published snapshot. It stays valid and unchanged
+// until the next call.
+const SimSnapshot* SimThread_Latest(SimThread* st);
+
+// Render thread: queue a direction for the next tick (dropped if the ring is
+// full).
+void SimThread_QueueDir(SimThread* st, Dir d);
+
+// Render thread: start a new game once the current one has ended.
+void SimThread_RequestContinue(SimThread* st);
+
+// Render thread: ticks simulated since the previous call.
+int SimThread_TakeTicks(SimThread* st);
@@ -10,13 +10,25 @@
  * - Apply a “nice-feel” input model: a small direction buffer so quick turns
  *   register even if they happen between ticks.
  * - Track previous positions for interpolation. Rendering can lerp between
- *   prev and seg while simulation stays in clean, discrete steps.
+ *   Snake_Prev and Snake_Seg while simulation stays in clean, discrete steps.
+ *
+ * Storage:
+ * - The body is a ring buffer: segment i (0 = head) lives at
+ *   seg[(head + i) % cap]. A tick writes one new head slot and the tail drops
+ *   off implicitly, so advancing is O(1) regardless of length.
+ * - Previous positions are not copied. After a tick, segment i used to be
+ *   where segment i + 1 is now, and the slot just past the tail still holds
+ *   last tick's tail (cap is max_len + 1 for that reason).
+ *
+ * - occ[y * grid_w + x] counts the segments on each cell. It is updated on
+ *   head push / tail pop, so occupancy and self-collision checks are O(1).
+ * - The cells with a zero count form a free-cell set (dense array + position
+ *   map, swap-remove), so spawning on a uniformly random free cell is O(1).
  *
  * Important invariants:
- * - seg[0] is always the head.
+ * - Snake_Seg(s, 0) is always the head.
  * - len is the number of active segments (<= max_len).
- * - prev mirrors seg for the active segment range; it is updated at the start
- *   of each tick.
+ * - Read segments through Snake_Seg / Snake_Prev, never seg[] directly.
  */
 
 #include <stdbool.h>
@@ -46,9 +58,25 @@ typedef struct Snake {
     bool has_q1, has_q2;
     Dir q1, q2;
 
-    // Current + previous segment positions (for interpolation)
-    IVec2* seg;   // [len]
-    IVec2* prev;  // [len]
+    // Segment ring buffer (see "Storage" above).
+    IVec2* seg;   // [cap]
+    int cap;      // max_len + 1
+    int head;     // ring slot of segment 0
+
+    // Segments [0, prev_len) have a shifted previous position (they existed
+    // before the last tick). The rest (fresh growth, or everything after
+    // Snake_SyncPrev) report prev == seg.
+    int prev_len;
+
+    // Per-cell segment counts (grid_w * grid_h). A count of 2 on the head
+    // cell means the head ran into the body.
+    uint16_t* occ;
+
+    // Free-cell set: free_cells[0..free_count) lists every unoccupied cell in
+    // no particular order; free_pos[cell] is its slot there, or -1.
+    int* free_cells;
+    int* free_pos;
+    int free_count;
 } Snake;
 
 // Allocates segment arrays and places the snake at the center of the grid.
@@ -62,17 +90,65 @@ void Snake_Destroy(Snake* s);
 void Snake_QueueDir(Snake* s, Dir d);
 
 // Advances the simulation by one tick:
-// - copies seg -> prev
 // - applies one buffered direction change
-// - shifts body and moves head with wraparound
-// - applies one unit of growth if requested
+// - pushes a new head with wraparound (the old positions become prev)
+// - drops the tail, or keeps it as one unit of growth if requested
 void Snake_Tick(Snake* s);
 
 // Request growth. Growth is applied on subsequent ticks so movement stays consistent.
 void Snake_AddGrowth(Snake* s, int n);
 
-// Returns true if any snake segment occupies p.
+// Returns true if any snake segment occupies p. O(1).
 bool Snake_Occupies(const Snake* s, IVec2 p);
 
-// Convenience: return current head position (seg[0]).
-IVec2 Snake_Head(const Snake* s);
+// Returns true if the head overlaps any body segment (self-collision). O(1).
+bool Snake_HitSelf(const Snake* s);
+
+// Ring slot of segment i (0 <= i <= len, so one wrap is enough).
+static inline int Snake_RingSlot(const Snake* s, int i) {
+    int k = s->head + i;
+    return (k >= s->cap) ? (k - s->cap) : k;
+}
+
+// Segment i (0 = head) for 0 <= i < len.
+static inline IVec2 Snake_Seg(const Snake* s, int i) {
+    return s->seg[Snake_RingSlot(s, i)];
+}
+
+// Position of segment i before the last tick (interpolation source).
+// Before the tick, segment i sat where segment i + 1 sits now.
+static inline IVec2 Snake_Prev(const Snake* s, int i) {
+    return s->seg[Snake_RingSlot(s, (i < s->prev_len) ? (i + 1) : i)];
+}
+
+// Convenience: return current head position (segment 0).
+static inline IVec2 Snake_Head(const Snake* s) {
+    return s->seg[s->head];
+}
+
+// Convenience: return current tail position (segment len - 1).
+static inline IVec2 Snake_Tail(const Snake* s) {
+    return Snake_Seg(s, s->len - 1);
+}
+
+// True if any segment sits on cell index y * grid_w + x.
+static inline bool Snake_CellOccupied(const Snake* s, int cell) {
+    return s->occ[cell] != 0;
+}
+
+// Number of unoccupied cells.
+static inline int Snake_FreeCount(const Snake* s) {
+    return s->free_count;
+}
+
+// k-th unoccupied cell index (0 <= k < free_count). Picking k uniformly gives
+// a uniformly random free cell.
+static inline int Snake_FreeCell(const Snake* s, int k) {
+    return s->free_cells[k];
+}
+
+// Make prev match seg for every segment (freezes the current pose).
+void Snake_SyncPrev(Snake* s);
+
+// Immediately apply all pending growth by repeating the tail (win screen fill).
+void Snake_ForceWinFill(Snake* s);
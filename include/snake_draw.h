@@ -11,8 +11,8 @@
  *   without risking gameplay correctness.
  *
  * Interpolation model:
- * - The simulation updates snake->seg once per tick and stores last tick’s
- *   positions in snake->prev.
+ * - The simulation advances the snake once per tick; Snake_Prev reports last
+ *   tick’s positions and Snake_Seg the current ones.
  * - The main loop computes alpha = acc / tick_ns (0..1) and asks SnakeDraw to render intermediate positions.
  *
  * Bridging:
@@ -28,13 +28,14 @@
 
 // Settings for how the snake is drawn.
 typedef struct SnakeDrawStyle {
-    bool snap_head;          // Classic head snap look (head is drawn at seg[0] exactly).
+    bool snap_head;          // Classic head snap look (head is drawn at the head cell exactly).
     bool draw_bridges;       // Fill gaps between segments at corners/wraps.
     uint8_t head_r, head_g, head_b;
     uint8_t body_r, body_g, body_b;
 } SnakeDrawStyle;
 
 // Render the snake using interpolation alpha in [0,1].
-// - Uses snake->prev and snake->seg
+// - Uses Snake_Prev and Snake_Seg
 // - Can snap head and bridge gaps at turns/wraps
-void SnakeDraw_Render(const App* app, const Snake* snake, float alpha, SnakeDrawStyle style);
+// - Queues into app->rect_batch and submits it in three fill calls
+void SnakeDraw_Render(App* app, const Snake* snake, float alpha, SnakeDrawStyle style);
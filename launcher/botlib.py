@@ -29,6 +29,110 @@ class SnakeBotLib:
 
         self._lib.snakebot_version.restype = ctypes.c_char_p
 
+        self._lib.snakebot_workspace_size.argtypes = [ctypes.c_int, ctypes.c_int]
+        self._lib.snakebot_workspace_size.restype = ctypes.c_longlong
+
+        self._lib.snakebot_generate_cycle_ws.argtypes = [
+            ctypes.c_int,
+            ctypes.c_int,
+            ctypes.c_char_p,
+            ctypes.c_int,
+            ctypes.c_void_p,
+            ctypes.c_longlong,
+            ctypes.c_char_p,
+            ctypes.c_int,
+        ]
+        self._lib.snakebot_generate_cycle_ws.restype = ctypes.c_int
+
+        self._lib.snakebot_validate_cycle_ws.argtypes = [
+            ctypes.c_int,
+            ctypes.c_int,
+            ctypes.c_char_p,
+            ctypes.c_void_p,
+            ctypes.c_longlong,
+            ctypes.c_char_p,
+            ctypes.c_int,
+        ]
+        self._lib.snakebot_validate_cycle_ws.restype = ctypes.c_int
+
+        self._lib.snakebot_build_cycle_file_ex_ws.argtypes = [
+            ctypes.c_int, ctypes.c_int,
+            ctypes.c_int, ctypes.c_int,
+            ctypes.c_uint,
+            ctypes.c_char_p,
+            ctypes.c_char_p, ctypes.c_int,
+            ctypes.c_void_p, ctypes.c_longlong,
+            ctypes.c_char_p, ctypes.c_int,
+        ]
+        self._lib.snakebot_build_cycle_file_ex_ws.restype = ctypes.c_int
+
+        self._lib.snakebot_cycle_file_max_len.argtypes = [ctypes.c_int, ctypes.c_int]
+        self._lib.snakebot_cycle_file_max_len.restype = ctypes.c_longlong
+
+        self._lib.snakebot_build_cycle_files_batch.argtypes = [
+            ctypes.c_int, ctypes.c_int,
+            ctypes.c_int, ctypes.c_int,
+            ctypes.c_uint, ctypes.c_int,
+            ctypes.c_char_p,
+            ctypes.c_int,
+            ctypes.c_char_p, ctypes.c_longlong,
+            ctypes.POINTER(ctypes.c_int),
+            ctypes.c_void_p, ctypes.c_longlong,
+            ctypes.c_char_p, ctypes.c_int,
+        ]
+        self._lib.snakebot_build_cycle_files_batch.restype = ctypes.c_int
+
+        self._lib.snakebot_cycle_file_bin_size.argtypes = [ctypes.c_int, ctypes.c_int]
+        self._lib.snakebot_cycle_file_bin_size.restype = ctypes.c_longlong
+
+        self._lib.snakebot_build_cycle_file_bin_ws.argtypes = [
+            ctypes.c_int, ctypes.c_int,
+            ctypes.c_int, ctypes.c_int,
+            ctypes.c_uint,
+            ctypes.c_char_p,
+            ctypes.c_void_p, ctypes.c_longlong,
+            ctypes.c_void_p, ctypes.c_longlong,
+            ctypes.c_char_p, ctypes.c_int,
+        ]
+        self._lib.snakebot_build_cycle_file_bin_ws.restype = ctypes.c_int
+
+        self._lib.snakebot_validate_cycle_file_bin.argtypes = [
+            ctypes.c_char_p, ctypes.c_longlong,
+            ctypes.POINTER(ctypes.c_int),
+            ctypes.POINTER(ctypes.c_int),
+            ctypes.c_char_p, ctypes.c_int,
+        ]
+        self._lib.snakebot_validate_cycle_file_bin.restype = ctypes.c_int
+
+        self._lib.snakebot_save_cycle_file_ws.argtypes = [
+            ctypes.c_char_p,
+            ctypes.c_int, ctypes.c_int,
+            ctypes.c_int, ctypes.c_int,
+            ctypes.c_uint,
+            ctypes.c_char_p,
+            ctypes.c_int,
+            ctypes.c_void_p, ctypes.c_longlong,
+            ctypes.c_char_p, ctypes.c_int,
+        ]
+        self._lib.snakebot_save_cycle_file_ws.restype = ctypes.c_int
+
+        self._lib.snakebot_validate_cycle_file_path.argtypes = [
+            ctypes.c_char_p,
+            ctypes.POINTER(ctypes.c_int),
+            ctypes.POINTER(ctypes.c_int),
+            ctypes.c_char_p, ctypes.c_int,
+        ]
+        self._lib.snakebot_validate_cycle_file_path.restype = ctypes.c_int
+
+        self._lib.snakebot_validate_cycle_file_ws.argtypes = [
+            ctypes.c_char_p,
+            ctypes.POINTER(ctypes.c_int),
+            ctypes.POINTER(ctypes.c_int),
+            ctypes.c_void_p, ctypes.c_longlong,
+            ctypes.c_char_p, ctypes.c_int,
+        ]
+        self._lib.snakebot_validate_cycle_file_ws.restype = ctypes.c_int
+
         self._lib.snakebot_generate_cycle.argtypes = [
             ctypes.c_int,
             ctypes.c_int,
@@ -69,11 +173,19 @@ class SnakeBotLib:
     def version(self) -> str:
         return self._lib.snakebot_version().decode("utf-8", errors="replace")
 
+    def _workspace(self, cells: int) -> ctypes.Array[ctypes.c_char]:
+        # Scratch for the *_ws entry points; depends only on the cell count.
+        size = self._lib.snakebot_workspace_size(max(1, cells), 1)
+        if size < 0:
+            raise ValueError(f"board too large: {cells} cells")
+        return ctypes.create_string_buffer(size)
+
     def generate_cycle(self, w: int, h: int) -> str:
         out_len = (w * h + 1)
         out = ctypes.create_string_buffer(out_len)
         err = ctypes.create_string_buffer(512)
-        rc = self._lib.snakebot_generate_cycle(w, h, out, out_len, err, len(err))
+        ws = self._workspace(w * h)
+        rc = self._lib.snakebot_generate_cycle_ws(w, h, out, out_len, ws, len(ws), err, len(err))
         if rc != 0:
             raise RuntimeError(err.value.decode("utf-8", errors="replace") or f"generate failed rc={rc}")
         return out.value.decode("ascii")
@@ -87,31 +199,168 @@ class SnakeBotLib:
         seed: int,
         cycle_type: str,
     ) -> str:
-        # Conservative sizing: header/meta + grid + newlines.
-        out_len = w * h + 1024
+        # Conservative sizing: header/meta + grid + one newline per row.
+        out_len = w * h + h + 1024
         out = ctypes.create_string_buffer(out_len)
         err = ctypes.create_string_buffer(512)
-        rc = self._lib.snakebot_build_cycle_file_ex(
+        ws = self._workspace(w * h)
+        rc = self._lib.snakebot_build_cycle_file_ex_ws(
             w, h,
             int(window_w),
             int(window_h),
             ctypes.c_uint(int(seed) & 0xFFFFFFFF),
             cycle_type.encode("ascii", errors="ignore"),
             out, out_len,
+            ws, len(ws),
             err, len(err),
         )
         if rc != 0:
             raise RuntimeError(err.value.decode("utf-8", errors="replace") or f"build_cycle_file failed rc={rc}")
         return out.value.decode("ascii")
 
+    def build_cycle_files_batch(
+        self,
+        w: int,
+        h: int,
+        window_w: int,
+        window_h: int,
+        seed_first: int,
+        count: int,
+        cycle_type: str,
+        threads: int = 0,
+    ) -> list[str]:
+        # One call for a whole seed range; the library spreads it over
+        # `threads` workers (0 = one per CPU).
+        stride = self._lib.snakebot_cycle_file_max_len(w, h)
+        if stride < 0:
+            raise ValueError(f"invalid board size: {w}x{h}")
+        workers = threads if threads > 0 else (os.cpu_count() or 1)
+        workers = max(1, min(workers, count))
+        out = ctypes.create_string_buffer(stride * count)
+        rcs = (ctypes.c_int * count)()
+        err = ctypes.create_string_buffer(512)
+        ws_size = self._lib.snakebot_workspace_size(w, h)
+        ws = ctypes.create_string_buffer(ws_size * workers)
+        rc = self._lib.snakebot_build_cycle_files_batch(
+            w, h,
+            int(window_w),
+            int(window_h),
+            ctypes.c_uint(int(seed_first) & 0xFFFFFFFF),
+            count,
+            cycle_type.encode("ascii", errors="ignore"),
+            workers,
+            out, stride,
+            rcs,
+            ws, len(ws),
+            err, len(err),
+        )
+        if rc != 0:
+            raise RuntimeError(err.value.decode("utf-8", errors="replace") or f"build_cycle_files_batch failed rc={rc}")
+        raw = out.raw
+        return [
+            raw[i * stride:(i + 1) * stride].split(b"\0", 1)[0].decode("ascii")
+            for i in range(count)
+        ]
+
+    def build_cycle_file_bin(
+        self,
+        w: int,
+        h: int,
+        window_w: int,
+        window_h: int,
+        seed: int,
+        cycle_type: str,
+    ) -> bytes:
+        # Binary SNAKECYCLE 2 container: 64-byte header + 2 bits per cell.
+        out_len = self._lib.snakebot_cycle_file_bin_size(w, h)
+        if out_len < 0:
+            raise ValueError(f"invalid board size: {w}x{h}")
+        out = ctypes.create_string_buffer(out_len)
+        err = ctypes.create_string_buffer(512)
+        ws = self._workspace(w * h)
+        rc = self._lib.snakebot_build_cycle_file_bin_ws(
+            w, h,
+            int(window_w),
+            int(window_h),
+            ctypes.c_uint(int(seed) & 0xFFFFFFFF),
+            cycle_type.encode("ascii", errors="ignore"),
+            out, out_len,
+            ws, len(ws),
+            err, len(err),
+        )
+        if rc != 0:
+            raise RuntimeError(err.value.decode("utf-8", errors="replace") or f"build_cycle_file_bin failed rc={rc}")
+        return out.raw[:out_len]
+
+    def validate_cycle_file_bin(self, data: bytes) -> tuple[int, int]:
+        err = ctypes.create_string_buffer(512)
+        ow = ctypes.c_int(0)
+        oh = ctypes.c_int(0)
+        rc = self._lib.snakebot_validate_cycle_file_bin(
+            data, len(data),
+            ctypes.byref(ow),
+            ctypes.byref(oh),
+            err, len(err),
+        )
+        if rc != 0:
+            raise RuntimeError(err.value.decode("utf-8", errors="replace") or f"validate_cycle_file_bin failed rc={rc}")
+        return (int(ow.value), int(oh.value))
+
+    def save_cycle_file(
+        self,
+        path: str | os.PathLike[str],
+        w: int,
+        h: int,
+        window_w: int,
+        window_h: int,
+        seed: int,
+        cycle_type: str,
+        binary: bool = False,
+    ) -> None:
+        # Streams the file to disk in the library; no Python-side copy of
+        # the cycle is ever built.
+        err = ctypes.create_string_buffer(512)
+        ws = self._workspace(w * h)
+        rc = self._lib.snakebot_save_cycle_file_ws(
+            os.fsencode(path),
+            w, h,
+            int(window_w),
+            int(window_h),
+            ctypes.c_uint(int(seed) & 0xFFFFFFFF),
+            cycle_type.encode("ascii", errors="ignore"),
+            2 if binary else 1,
+            ws, len(ws),
+            err, len(err),
+        )
+        if rc != 0:
+            raise RuntimeError(err.value.decode("utf-8", errors="replace") or f"save_cycle_file failed rc={rc}")
+
+    def validate_cycle_file_path(self, path: str | os.PathLike[str]) -> tuple[int, int]:
+        err = ctypes.create_string_buffer(512)
+        ow = ctypes.c_int(0)
+        oh = ctypes.c_int(0)
+        rc = self._lib.snakebot_validate_cycle_file_path(
+            os.fsencode(path),
+            ctypes.byref(ow),
+            ctypes.byref(oh),
+            err, len(err),
+        )
+        if rc != 0:
+            raise RuntimeError(err.value.decode("utf-8", errors="replace") or f"validate_cycle_file_path failed rc={rc}")
+        return (int(ow.value), int(oh.value))
+
     def validate_cycle_file(self, cycle_file_text: str) -> tuple[int, int]:
         err = ctypes.create_string_buffer(512)
         ow = ctypes.c_int(0)
         oh = ctypes.c_int(0)
-        rc = self._lib.snakebot_validate_cycle_file(
-            cycle_file_text.encode("ascii", errors="ignore"),
+        text = cycle_file_text.encode("ascii", errors="ignore")
+        # A valid file holds at least one byte per cell, so this always fits.
+        ws = self._workspace(len(text))
+        rc = self._lib.snakebot_validate_cycle_file_ws(
+            text,
             ctypes.byref(ow),
             ctypes.byref(oh),
+            ws, len(ws),
             err, len(err)
         )
         if rc != 0:
@@ -120,6 +369,9 @@ class SnakeBotLib:
 
     def validate_cycle(self, w: int, h: int, cycle: str) -> None:
         err = ctypes.create_string_buffer(512)
-        rc = self._lib.snakebot_validate_cycle(w, h, cycle.encode("ascii", errors="ignore"), err, len(err))
+        ws = self._workspace(w * h)
+        rc = self._lib.snakebot_validate_cycle_ws(
+            w, h, cycle.encode("ascii", errors="ignore"), ws, len(ws), err, len(err)
+        )
         if rc != 0:
             raise RuntimeError(err.value.decode("utf-8", errors="replace") or f"validate failed rc={rc}")
@@ -171,15 +171,20 @@ class App(ctk.CTk):
             2000,
             5000,
             7000,
+            "max",
         ]
         self.bot_tps_index = ctk.IntVar(value=self.bot_tps_steps.index(20))
         self.seed_var = ctk.StringVar(value="")
         self.cycle_type_var = ctk.StringVar(value="Maze-based")
+        self.bot_mode_var = ctk.StringVar(value="Cycle shortcuts")
+        self.cycle_binary_var = ctk.BooleanVar(value=False)
         self.human_w_var = ctk.StringVar(value="40")
         self.human_h_var = ctk.StringVar(value="30")
         self.human_seed_var = ctk.StringVar(value="")
         self.bot_bgm_var = ctk.BooleanVar(value=True)
         self.human_bgm_var = ctk.BooleanVar(value=True)
+        self.bot_vsync_var = ctk.BooleanVar(value=False)
+        self.human_vsync_var = ctk.BooleanVar(value=False)
 
         self.tuning_presets = {
             "Safe": {
@@ -295,6 +300,12 @@ class App(ctk.CTk):
             width=140,
         ).grid(row=3, column=1, sticky="w", padx=10, pady=(0, 10))
 
+        ctk.CTkCheckBox(
+            grid,
+            text="Packed binary (SNAKECYCLE 2)",
+            variable=self.cycle_binary_var,
+        ).grid(row=3, column=2, sticky="w", padx=10, pady=(0, 10))
+
         grid.grid_columnconfigure(2, weight=1)
 
         # --- Bot config ---
@@ -330,6 +341,22 @@ class App(ctk.CTk):
             variable=self.bot_bgm_var,
         ).grid(row=3, column=0, columnspan=2, sticky="w", padx=10, pady=(0, 10))
 
+        ctk.CTkCheckBox(
+            bot_cfg,
+            text="VSync",
+            variable=self.bot_vsync_var,
+        ).grid(row=3, column=2, sticky="w", padx=10, pady=(0, 10))
+
+        ctk.CTkLabel(bot_cfg, text="Bot mode").grid(
+            row=4, column=0, sticky="w", padx=10
+        )
+        ctk.CTkOptionMenu(
+            bot_cfg,
+            variable=self.bot_mode_var,
+            values=["Cycle shortcuts", "Path planner", "Cycle repair"],
+            width=140,
+        ).grid(row=5, column=0, columnspan=2, sticky="w", padx=10, pady=(0, 10))
+
         bot_cfg.grid_columnconfigure(0, weight=1)
         bot_cfg.grid_columnconfigure(1, weight=0, minsize=60)
 
@@ -496,6 +523,12 @@ class App(ctk.CTk):
             variable=self.human_bgm_var,
         ).grid(row=3, column=0, columnspan=2, sticky="w", padx=10, pady=(0, 10))
 
+        ctk.CTkCheckBox(
+            human,
+            text="VSync",
+            variable=self.human_vsync_var,
+        ).grid(row=3, column=2, sticky="w", padx=10, pady=(0, 10))
+
         self.launch_human_btn = ctk.CTkButton(
             human, text="Launch game (human)", command=self.on_launch_human
         )
@@ -747,24 +780,27 @@ class App(ctk.CTk):
             if (win_w % w) != 0 or (win_h % h) != 0:
                 raise ValueError("Window size must be divisible by grid size")
 
-            cycle_file = lib.build_cycle_file(
+            lib.save_cycle_file(
+                out_path,
                 w,
                 h,
                 win_w,
                 win_h,
                 seed=seed,
                 cycle_type=cycle_type,
+                binary=self.cycle_binary_var.get(),
             )
             try:
-                fw, fh = lib.validate_cycle_file(cycle_file)
+                fw, fh = lib.validate_cycle_file_path(out_path)
             except Exception as e:
+                out_path.unlink(missing_ok=True)
                 raise RuntimeError(f"Generated cycle invalid: {e}") from e
             if (fw, fh) != (w, h):
+                out_path.unlink(missing_ok=True)
                 raise RuntimeError(
                     f"Library returned mismatched dimensions: {fw}x{fh}"
                 )
 
-            out_path.write_text(cycle_file, encoding="ascii")
             self.log(f"Generated valid .cycle for {w}x{h}: {out_path}")
             self.log(f"Seed used: {seed}")
             self.log("Tip: Odd×odd grids use wrapping for the cycle.")
@@ -787,9 +823,7 @@ class App(ctk.CTk):
             # Safety: verify file content before launching.
             lib = self._get_lib()
             try:
-                lib.validate_cycle_file(
-                    out_path.read_text(encoding="ascii", errors="ignore")
-                )
+                lib.validate_cycle_file_path(out_path)
             except Exception as e:
                 raise RuntimeError(f"Cycle file invalid: {e}") from e
 
@@ -808,6 +842,12 @@ class App(ctk.CTk):
             ]
             if not self.bot_bgm_var.get():
                 cmd.append("--no-bgm")
+            if self.bot_vsync_var.get():
+                cmd.append("--vsync")
+            mode = {"Path planner": "plan", "Cycle repair": "repair"}.get(
+                self.bot_mode_var.get(), "cycle"
+            )
+            cmd += ["--bot-mode", mode]
             tuning = self._current_tuning()
             cmd += [
                 "--bot-k-progress",
@@ -851,6 +891,8 @@ class App(ctk.CTk):
                 cmd += ["--seed", str(seed)]
             if not self.human_bgm_var.get():
                 cmd.append("--no-bgm")
+            if self.human_vsync_var.get():
+                cmd.append("--vsync")
 
             self.log("Launching: " + " ".join(cmd))
             subprocess.Popen(cmd, cwd=str(game.parent))
@@ -50,6 +50,17 @@ bool App_Init(App* app, int window_w, int window_h, int grid_w, int grid_h) {
     app->cell_w = window_w / app->grid_w;
     app->cell_h = window_h / app->grid_h;
 
+    app->rect_batch = (RenderBatch){0};
+    app->frame_arena = (FrameArena){0};
+    app->frames = 0;
+    app->frames_with_allocs = 0;
+    app->last_alloc_frame = 0;
+    app->last_frame_allocs = 0;
+    app->alloc_mark = 0;
+    app->grid_tex = NULL;
+    app->grid_tex_dim = NULL;
+    app->grid_tex_failed = false;
+
     if (!SDL_Init(SDL_INIT_VIDEO)) {
         SDL_Log("SDL_Init failed: %s", SDL_GetError());
         return false;
@@ -75,8 +86,38 @@ bool App_Init(App* app, int window_w, int window_h, int grid_w, int grid_h) {
     return true;
 }
 
+void App_BeginFrame(App* app) {
+    if (!app) return;
+
+    uint64_t total = app->rect_batch.heap_allocs + app->frame_arena.heap_allocs;
+    if (app->frames > 0) {
+        app->last_frame_allocs = total - app->alloc_mark;
+        if (app->last_frame_allocs > 0) {
+            app->frames_with_allocs++;
+            app->last_alloc_frame = app->frames;
+        }
+    }
+    app->alloc_mark = total;
+    app->frames++;
+
+    FrameArena_Reset(&app->frame_arena);
+}
+
 void App_Shutdown(App* app) {
     if (!app) return;
+    if (app->frames > 0) {
+        SDL_Log("Render heap allocations: %llu frames, %llu with allocations "
+                "(last at frame %llu)",
+                (unsigned long long)app->frames,
+                (unsigned long long)app->frames_with_allocs,
+                (unsigned long long)app->last_alloc_frame);
+    }
+    RenderBatch_Destroy(&app->rect_batch);
+    FrameArena_Destroy(&app->frame_arena);
+    if (app->grid_tex) SDL_DestroyTexture(app->grid_tex);
+    if (app->grid_tex_dim) SDL_DestroyTexture(app->grid_tex_dim);
+    app->grid_tex = NULL;
+    app->grid_tex_dim = NULL;
     if (app->renderer) SDL_DestroyRenderer(app->renderer);
     if (app->window) SDL_DestroyWindow(app->window);
     app->renderer = NULL;
@@ -7,40 +7,21 @@
  * Apple placement and respawn logic.
  *
  * Constraint: never spawn inside the snake.
- * Random tries are cheap early; a scan guarantees progress when crowded.
+ * The snake maintains its set of free cells, so a spawn is one uniform draw
+ * from that set: O(1) no matter how full the board is.
  */
 
 #include <SDL3/SDL.h>
 
-static IVec2 random_pos(int w, int h) {
-    IVec2 p;
-    p.x = (int)SDL_rand((Uint64)w);
-    p.y = (int)SDL_rand((Uint64)h);
-    return p;
-}
-
 static void spawn_avoiding_snake(Apple* a, const Snake* s) {
-    // Try random a bunch of times; if snake fills most of board, fall back to scan.
-    for (int tries = 0; tries < 1024; tries++) {
-        IVec2 p = random_pos(s->grid_w, s->grid_h);
-        if (!Snake_Occupies(s, p)) {
-            a->pos = p;
-            return;
-        }
-    }
-
-    // Fallback: deterministic scan for first empty cell
-    for (int y = 0; y < s->grid_h; y++) {
-        for (int x = 0; x < s->grid_w; x++) {
-            IVec2 p = { x, y };
-            if (!Snake_Occupies(s, p)) {
-                a->pos = p;
-                return;
-            }
-        }
-    }
+    int free_n = Snake_FreeCount(s);
 
     // Board full: keep position as-is (game would be "won")
+    if (free_n <= 0) return;
+
+    int cell = Snake_FreeCell(s, (int)SDL_rand((Sint32)free_n));
+    a->pos.x = cell % s->grid_w;
+    a->pos.y = cell / s->grid_w;
 }
 
 void Apple_Init(Apple* a, const Snake* s) {
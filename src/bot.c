@@ -1,5 +1,6 @@
 #include "bot.h"
 
+#include <SDL3/SDL.h>
 #include <limits.h>
 #include <math.h>
 #include <stdio.h>
@@ -104,6 +105,10 @@ static int clampi(int v, int lo, int hi) {
 void apply_preset(Preset p, BotTuning *t) {
   if (!t)
     return;
+  const BotMode mode = t->mode;
+  const int plan_budget_us = t->plan_budget_us;
+  const int tick_budget_us = t->tick_budget_us;
+  const int lookahead_depth = t->lookahead_depth;
   switch (p) {
   case PRESET_AGGRESSIVE:
     *t = (BotTuning){.k_progress = 14.0,
@@ -147,6 +152,10 @@ void apply_preset(Preset p, BotTuning *t) {
                      .max_skip_cap = 0};
     break;
   }
+  t->mode = mode;
+  t->plan_budget_us = plan_budget_us;
+  t->tick_budget_us = tick_budget_us;
+  t->lookahead_depth = lookahead_depth;
 }
 
 bool preset_matches_current(Preset p, const BotTuning *t, double epsilon) {
@@ -173,6 +182,76 @@ bool preset_matches_current(Preset p, const BotTuning *t, double epsilon) {
   return true;
 }
 
+bool preset_from_name(const char *name, Preset *out) {
+  if (!name || !out)
+    return false;
+  if (strcmp(name, "safe") == 0) {
+    *out = PRESET_SAFE;
+    return true;
+  }
+  if (strcmp(name, "aggressive") == 0) {
+    *out = PRESET_AGGRESSIVE;
+    return true;
+  }
+  if (strcmp(name, "greedy") == 0 || strcmp(name, "greedy-apple") == 0 ||
+      strcmp(name, "greedy_apple") == 0) {
+    *out = PRESET_GREEDY_APPLE;
+    return true;
+  }
+  if (strcmp(name, "chaotic") == 0) {
+    *out = PRESET_CHAOTIC;
+    return true;
+  }
+  return false;
+}
+
+int parse_tuning_arg(int argc, char **argv, int i, BotTuning *t) {
+  if (!argv || !t || i < 0 || i + 1 >= argc)
+    return 0;
+  const char *flag = argv[i];
+  const char *val = argv[i + 1];
+  if (strcmp(flag, "--bot-preset") == 0) {
+    Preset p;
+    if (!preset_from_name(val, &p))
+      return -1;
+    apply_preset(p, t);
+  } else if (strcmp(flag, "--bot-mode") == 0) {
+    if (strcmp(val, "cycle") == 0)
+      t->mode = BOT_MODE_CYCLE;
+    else if (strcmp(val, "plan") == 0)
+      t->mode = BOT_MODE_PLAN;
+    else if (strcmp(val, "repair") == 0)
+      t->mode = BOT_MODE_REPAIR;
+    else
+      return -1;
+  } else if (strcmp(flag, "--bot-plan-budget-us") == 0) {
+    t->plan_budget_us = atoi(val);
+  } else if (strcmp(flag, "--bot-tick-budget-us") == 0) {
+    t->tick_budget_us = atoi(val);
+  } else if (strcmp(flag, "--bot-lookahead") == 0) {
+    t->lookahead_depth = atoi(val);
+  } else if (strcmp(flag, "--bot-k-progress") == 0) {
+    t->k_progress = strtod(val, NULL);
+  } else if (strcmp(flag, "--bot-k-away") == 0) {
+    t->k_away = strtod(val, NULL);
+  } else if (strcmp(flag, "--bot-k-skip") == 0) {
+    t->k_skip = strtod(val, NULL);
+  } else if (strcmp(flag, "--bot-k-slack") == 0) {
+    t->k_slack = strtod(val, NULL);
+  } else if (strcmp(flag, "--bot-k-loop") == 0) {
+    t->k_loop = strtod(val, NULL);
+  } else if (strcmp(flag, "--bot-loop-window") == 0) {
+    t->loop_window = atoi(val);
+  } else if (strcmp(flag, "--bot-aggression-scale") == 0) {
+    t->aggression_scale = strtod(val, NULL);
+  } else if (strcmp(flag, "--bot-max-skip-cap") == 0) {
+    t->max_skip_cap = atoi(val);
+  } else {
+    return 0;
+  }
+  return 1;
+}
+
 static BotTuning clamp_tuning(const BotTuning *t) {
   BotTuning out = *t;
   out.k_progress = clampd(out.k_progress, 0.0, 50.0);
@@ -183,6 +262,15 @@ static BotTuning clamp_tuning(const BotTuning *t) {
   out.aggression_scale = clampd(out.aggression_scale, 0.0, 2.0);
   out.loop_window = clampi(out.loop_window, 1, 200);
   out.max_skip_cap = clampi(out.max_skip_cap, 0, 10000);
+  if (out.mode != BOT_MODE_PLAN && out.mode != BOT_MODE_REPAIR)
+    out.mode = BOT_MODE_CYCLE;
+  if (out.plan_budget_us <= 0)
+    out.plan_budget_us = BOT_PLAN_BUDGET_US;
+  out.plan_budget_us = clampi(out.plan_budget_us, 1, 1000000);
+  out.tick_budget_us = clampi(out.tick_budget_us, 0, 1000000);
+  if (out.lookahead_depth <= 0)
+    out.lookahead_depth = BOT_LOOKAHEAD_DEPTH;
+  out.lookahead_depth = clampi(out.lookahead_depth, 1, BOT_LOOKAHEAD_MAX_DEPTH);
   return out;
 }
 
@@ -194,34 +282,120 @@ static Dir flip_x_dir(Dir d) {
   return d;
 }
 
-static bool is_occupied_idx(const Bot *b, int idx, int tail_idx,
-                            bool tail_free) {
+// Occupancy by cycle index, read from the snake's own per-cell counts (O(1)).
+static bool is_occupied_idx(const Bot *b, const Snake *s, int idx,
+                            int tail_idx, bool tail_free) {
   if (!b || idx < 0)
     return false;
   if (tail_free && idx == tail_idx)
     return false;
-  return b->occupied_idx[idx] != 0;
+  IVec2 p = b->pos_of_idx[idx];
+  return Snake_CellOccupied(s, cell_index(b->grid_w, p.x, p.y));
 }
 
+// ------------------------------
+// Occupancy in cycle order
+// ------------------------------
+
+// Bit i of occ_bits is set while the cell at cycle index i holds a segment.
+
+static inline void occ_set(Bot *b, const Snake *s, int cell) {
+  int idx = b->cycle_index[cell];
+  uint64_t bit = (uint64_t)1 << (idx & 63);
+  if (Snake_CellOccupied(s, cell))
+    b->occ_bits[idx >> 6] |= bit;
+  else
+    b->occ_bits[idx >> 6] &= ~bit;
+}
+
+static void occ_rebuild(Bot *b, const Snake *s) {
+  memset(b->occ_bits, 0, (size_t)((b->n_cells + 63) >> 6) * sizeof(uint64_t));
+  for (int i = 0; i < b->n_cells; i++) {
+    IVec2 p = b->pos_of_idx[i];
+    if (Snake_CellOccupied(s, cell_index(b->grid_w, p.x, p.y)))
+      b->occ_bits[i >> 6] |= (uint64_t)1 << (i & 63);
+  }
+}
+
+static bool cells_adjacent(const Bot *b, int a, int c) {
+  IVec2 p = (IVec2){a % b->grid_w, a / b->grid_w};
+  const Dir dirs[4] = {DIR_UP, DIR_DOWN, DIR_LEFT, DIR_RIGHT};
+  for (int i = 0; i < 4; i++) {
+    IVec2 q = wrap_step(p, dirs[i], b->grid_w, b->grid_h);
+    if (cell_index(b->grid_w, q.x, q.y) == c)
+      return true;
+  }
+  return false;
+}
+
+// Brings occ_bits up to date with s. A single Snake_Tick since the last call
+// only changes the new head cell and the old tail cell: O(1). A reset
+// (cycle_pos -1: new game or new cycle) rebuilds in O(n); so does a snake
+// that did not advance exactly one tick, as a guard against a missed reset.
+static void occ_sync(Bot *b, const Snake *s, int head_cell, int tail_cell) {
+  if (b->cycle_pos >= 0 && head_cell == b->occ_head_cell &&
+      tail_cell == b->occ_tail_cell && s->len == b->occ_len)
+    return;
+
+  bool one_tick = b->cycle_pos >= 0 &&
+                  (s->len == b->occ_len || s->len == b->occ_len + 1);
+  if (one_tick) {
+    if (s->len > 1) {
+      IVec2 p = Snake_Seg(s, 1);
+      one_tick = cell_index(b->grid_w, p.x, p.y) == b->occ_head_cell;
+    } else {
+      one_tick = cells_adjacent(b, b->occ_head_cell, head_cell);
+    }
+  }
+
+  if (one_tick) {
+    occ_set(b, s, head_cell);
+    occ_set(b, s, b->occ_tail_cell);
+  } else {
+    occ_rebuild(b, s);
+  }
+
+  b->occ_head_cell = head_cell;
+  b->occ_tail_cell = tail_cell;
+  b->occ_len = s->len;
+}
+
+// Any segment on cycle indices [lo, hi) other than skip (-1 for none)?
+// Scans 64 indices per word and stops at the first occupied one.
+static bool occ_any(const Bot *b, int lo, int hi, int skip) {
+  const int last = (hi - 1) >> 6;
+  for (int w = lo >> 6; w <= last; w++) {
+    uint64_t m = b->occ_bits[w];
+    if (w == lo >> 6)
+      m &= ~(uint64_t)0 << (lo & 63);
+    if (w == last)
+      m &= ~(uint64_t)0 >> (63 - ((hi - 1) & 63));
+    if (skip >= 0 && w == skip >> 6)
+      m &= ~((uint64_t)1 << (skip & 63));
+    if (m)
+      return true;
+  }
+  return false;
+}
+
+// Every cycle index in (head_idx, target_idx] is free: a word-at-a-time scan
+// of occ_bits instead of a lookup per cell.
 static bool corridor_clear(const Bot *b, int head_idx, int target_idx,
                            int tail_idx, bool tail_free, int n, int max_skip) {
   int d = dist_idx(head_idx, target_idx, n);
   if (d < 1 || d > max_skip)
     return false;
-  for (int step = 1; step <= d; step++) {
-    int idx = head_idx + step;
-    if (idx >= n)
-      idx -= n;
-    if (idx == tail_idx && tail_free)
-      continue;
-    if (b->occupied_idx[idx])
-      return false;
-  }
-  return true;
+  int skip = tail_free ? tail_idx : -1;
+  int first = head_idx + 1;
+  if (first + d <= n)
+    return !occ_any(b, first, first + d, skip);
+  if (first < n && occ_any(b, first, n, skip))
+    return false;
+  return !occ_any(b, 0, first + d - n, skip);
 }
 
-static int free_neighbors_after(const Bot *b, IVec2 pos, int tail_idx,
-                                bool tail_free) {
+static int free_neighbors_after(const Bot *b, const Snake *s, IVec2 pos,
+                                int tail_idx, bool tail_free) {
   int count = 0;
   const IVec2 dirs[4] = {{0, -1}, {0, 1}, {-1, 0}, {1, 0}};
   for (int i = 0; i < 4; i++) {
@@ -229,20 +403,45 @@ static int free_neighbors_after(const Bot *b, IVec2 pos, int tail_idx,
     if (q.x < 0 || q.x >= b->grid_w || q.y < 0 || q.y >= b->grid_h)
       continue;
     int idx = b->cycle_index[cell_index(b->grid_w, q.x, q.y)];
-    if (!is_occupied_idx(b, idx, tail_idx, tail_free))
+    if (!is_occupied_idx(b, s, idx, tail_idx, tail_free))
       count++;
   }
   return count;
 }
 
+// Longest shortcut allowed with this head->tail gap: it shrinks as the snake
+// fills the board (aggression) and never exceeds the gap itself.
+static int max_skip_for(const Bot *b, int gap, int len) {
+  double aggression = 1.0 - ((double)len / (double)b->n_cells);
+  aggression *= b->tuning.aggression_scale;
+  aggression = clampd(aggression, 0.0, 1.0);
+
+  int max_skip = 1;
+  if (gap > 1) {
+    int extra = (int)(aggression * (double)(gap - 1));
+    if (extra < 0)
+      extra = 0;
+    max_skip += extra;
+  }
+  if (b->tuning.max_skip_cap > 0 && max_skip > b->tuning.max_skip_cap)
+    max_skip = b->tuning.max_skip_cap;
+  if (gap > 0 && max_skip > gap)
+    max_skip = gap;
+  if (max_skip < 1)
+    max_skip = 1;
+  return max_skip;
+}
+
 // Rank a candidate move; higher is better. Safety gates are handled outside.
-static double score_move(const Bot *b, const BotTuning *t, int head_idx,
-                         int tail_idx, int target, int gap, int max_skip,
-                         int len, IVec2 pos, const Apple *a, bool tail_free,
-                         int d) {
+static double score_move(const Bot *b, const Snake *s, const BotTuning *t,
+                         int head_idx, int tail_idx, int target, int gap,
+                         int max_skip, IVec2 pos, const Apple *a,
+                         bool tail_free, int d) {
   if (!t)
     return -1e9;
 
+  const int len = s->len;
+
   int apple_cell = cell_index(b->grid_w, a->pos.x, a->pos.y);
   int apple_idx = b->cycle_index[apple_cell];
   if (apple_idx < 0)
@@ -290,7 +489,7 @@ static double score_move(const Bot *b, const BotTuning *t, int head_idx,
   }
 
   if (len > 6) {
-    int free_n = free_neighbors_after(b, pos, tail_idx, tail_free);
+    int free_n = free_neighbors_after(b, s, pos, tail_idx, tail_free);
     if (free_n <= 1)
       return -1e9;
   }
@@ -306,6 +505,799 @@ static int idx_of_pos(const Bot *b, IVec2 p) {
   return b->cycle_index[cell];
 }
 
+// ------------------------------
+// Path planner (BOT_MODE_PLAN)
+// ------------------------------
+
+// Once the snake fills this share of the board, the planner stops cutting
+// across it and settles onto the cycle (see plan_next_dir).
+#define PLAN_SETTLE_FILL 0.3
+
+// Extra ticks the tail may be held back by apples eaten while settling.
+#define PLAN_SETTLE_SLACK 2
+
+// Likewise for apples eaten on the way onto the body's trail, where a path or
+// move can afford it (see sim_trail_dist).
+#define PLAN_TRAIL_SLACK 1
+
+// In PLAN_CYCLE, cycle repair retries while the apple stays put are spaced
+// this many to the apple's distance along the cycle (never closer than
+// REPAIR_RETRY_TICKS), so their cost per tick stays flat on big boards.
+#define PLAN_REPAIR_RETRIES 16
+
+static Dir opposite_dir(Dir d) {
+  switch (d) {
+  case DIR_UP:
+    return DIR_DOWN;
+  case DIR_DOWN:
+    return DIR_UP;
+  case DIR_LEFT:
+    return DIR_RIGHT;
+  case DIR_RIGHT:
+  default:
+    return DIR_LEFT;
+  }
+}
+
+static void plan_clear(BotPlan *p) {
+  p->len = 0;
+  p->step = 0;
+  p->phase = PLAN_FREE;
+  p->run = 0;
+  p->stuck = 0;
+}
+
+static void plan_next_stamp(BotPlan *p, int n) {
+  if (++p->stamp == 0) {
+    memset(p->seen, 0, (size_t)n * sizeof(uint32_t));
+    p->stamp = 1;
+  }
+}
+
+// Breadth-first search from the head over cells the snake will have left by
+// the time the head gets there: segment i (0 = head) is gone after
+// len - i + grow ticks. Stops at the apple and returns its depth, or -1 if
+// it can't be reached or the deadline passed.
+static int plan_search(Bot *b, const Snake *s, int apple_cell,
+                       uint64_t deadline_ns) {
+  BotPlan *p = &b->plan;
+  const int w = b->grid_w;
+  plan_next_stamp(p, b->n_cells);
+
+  for (int i = 0; i < s->len; i++) {
+    IVec2 q = Snake_Seg(s, i);
+    p->seg[cell_index(w, q.x, q.y)] = i;
+  }
+
+  IVec2 head = Snake_Head(s);
+  int head_cell = cell_index(w, head.x, head.y);
+  int grow = (s->len < s->max_len) ? s->grow : 0;
+
+  p->seen[head_cell] = p->stamp;
+  p->dist[head_cell] = 0;
+  int q_head = 0;
+  int q_tail = 0;
+  p->bfs[q_tail++] = head_cell;
+
+  const Dir dirs[4] = {DIR_UP, DIR_DOWN, DIR_LEFT, DIR_RIGHT};
+  while (q_head < q_tail) {
+    if ((q_head & 255) == 255 && SDL_GetTicksNS() > deadline_ns)
+      return -1;
+    int c = p->bfs[q_head++];
+    int t = p->dist[c] + 1;
+    IVec2 cp = (IVec2){c % w, c / w};
+    for (int i = 0; i < 4; i++) {
+      if (c == head_cell && s->len > 1 && is_opposite(s->dir, dirs[i]))
+        continue;
+      IVec2 q = wrap_step(cp, dirs[i], w, b->grid_h);
+      int qc = cell_index(w, q.x, q.y);
+      if (p->seen[qc] == p->stamp)
+        continue;
+      if (Snake_CellOccupied(s, qc) && t < s->len - p->seg[qc] + grow)
+        continue;
+      p->seen[qc] = p->stamp;
+      p->dist[qc] = t;
+      p->from[qc] = (uint8_t)dirs[i];
+      if (qc == apple_cell)
+        return t;
+      p->bfs[q_tail++] = qc;
+    }
+  }
+  return -1;
+}
+
+// Writes the search moves that reach cell into out[0..dist[cell]).
+static void plan_trace(Bot *b, int cell, Dir *out) {
+  BotPlan *p = &b->plan;
+  const int w = b->grid_w;
+  int c = cell;
+  for (int k = p->dist[cell] - 1; k >= 0; k--) {
+    Dir d = (Dir)p->from[c];
+    out[k] = d;
+    IVec2 q = wrap_step((IVec2){c % w, c / w}, opposite_dir(d), w, b->grid_h);
+    c = cell_index(w, q.x, q.y);
+  }
+}
+
+// A copy of the body played forward: p->queue is a ring of cells from tail to
+// head, p->occ holds counts (all zero between uses).
+typedef struct PlanSim {
+  int front, count, grow, head;
+} PlanSim;
+
+static void sim_load(Bot *b, const Snake *s, PlanSim *sim) {
+  BotPlan *p = &b->plan;
+  const int w = b->grid_w;
+  sim->front = 0;
+  sim->count = 0;
+  sim->grow = s->grow;
+  for (int i = s->len - 1; i >= 0; i--) {
+    IVec2 q = Snake_Seg(s, i);
+    int c = cell_index(w, q.x, q.y);
+    p->queue[sim->count++] = c;
+    p->occ[c]++;
+  }
+  IVec2 h = Snake_Head(s);
+  sim->head = cell_index(w, h.x, h.y);
+}
+
+static void sim_unload(Bot *b, const PlanSim *sim) {
+  BotPlan *p = &b->plan;
+  const int ring = b->n_cells + 1;
+  for (int j = 0; j < sim->count; j++)
+    p->occ[p->queue[(sim->front + j) % ring]] = 0;
+}
+
+// One tick into cell (as Snake_Tick: the tail drops first unless growing).
+// Returns false if the head runs into the body.
+static bool sim_step(Bot *b, const Snake *s, PlanSim *sim, int cell) {
+  BotPlan *p = &b->plan;
+  const int ring = b->n_cells + 1;
+  if (sim->grow > 0 && sim->count < s->max_len) {
+    sim->grow--;
+  } else {
+    p->occ[p->queue[sim->front]]--;
+    sim->front = (sim->front + 1) % ring;
+    sim->count--;
+  }
+  bool ok = p->occ[cell] == 0;
+  p->occ[cell]++;
+  p->queue[(sim->front + sim->count) % ring] = cell;
+  sim->count++;
+  sim->head = cell;
+  return ok;
+}
+
+static int sim_move(const Bot *b, int cell, Dir d) {
+  const int w = b->grid_w;
+  IVec2 q = wrap_step((IVec2){cell % w, cell / w}, d, w, b->grid_h);
+  return cell_index(w, q.x, q.y);
+}
+
+// Ticks until the simulated head can get onto its body's trail: a cell of
+// segment j (counted from the tail) reached no earlier than j + 1 + grow +
+// slack ticks, when it has been left. From there the head can follow the body
+// segment by segment and then its own tail for good. Searches free cells; -1
+// if there is no such cell or the deadline passed.
+static int sim_trail_dist(Bot *b, const PlanSim *sim, int slack,
+                          uint64_t deadline_ns) {
+  BotPlan *p = &b->plan;
+  const int ring = b->n_cells + 1;
+  if (sim->count <= 1)
+    return 0;
+  plan_next_stamp(p, b->n_cells);
+
+  for (int j = 0; j < sim->count; j++)
+    p->seg[p->queue[(sim->front + j) % ring]] = j;
+
+  p->seen[sim->head] = p->stamp;
+  p->dist[sim->head] = 0;
+  int q_head = 0;
+  int q_tail = 0;
+  p->bfs[q_tail++] = sim->head;
+
+  const Dir dirs[4] = {DIR_UP, DIR_DOWN, DIR_LEFT, DIR_RIGHT};
+  while (q_head < q_tail) {
+    if ((q_head & 255) == 255 && SDL_GetTicksNS() > deadline_ns)
+      return -1;
+    int c = p->bfs[q_head++];
+    int t = p->dist[c] + 1;
+    for (int i = 0; i < 4; i++) {
+      int qc = sim_move(b, c, dirs[i]);
+      if (p->seen[qc] == p->stamp)
+        continue;
+      if (p->occ[qc]) {
+        if (t >= p->seg[qc] + 1 + sim->grow + slack)
+          return t;
+        continue;
+      }
+      p->seen[qc] = p->stamp;
+      p->dist[qc] = t;
+      p->bfs[q_tail++] = qc;
+    }
+  }
+  return -1;
+}
+
+// Whether following the cycle strictly from the simulated state leaves the
+// whole body on it (final length - 1 moves) without a collision, with the
+// tail held back PLAN_SETTLE_SLACK extra ticks for apples eaten on the way.
+// Consumes the simulation.
+static bool sim_settles(Bot *b, const Snake *s, PlanSim *sim) {
+  sim->grow += PLAN_SETTLE_SLACK;
+  int final_len = sim->count + sim->grow;
+  if (final_len > s->max_len)
+    final_len = s->max_len;
+  int c = sim->head;
+  for (int k = 0; k < final_len - 1; k++) {
+    IVec2 q = b->pos_of_idx[b->next_cycle_idx[b->cycle_index[c]]];
+    c = cell_index(b->grid_w, q.x, q.y);
+    if (!sim_step(b, s, sim, c))
+      return false;
+  }
+  return true;
+}
+
+// A path to the apple is taken if the snake survives it and, with the apple
+// eaten, can still get onto its trail: it can always follow itself from there.
+static bool plan_accept(Bot *b, const Snake *s, const Dir *path, int len,
+                        uint64_t deadline_ns) {
+  PlanSim sim;
+  sim_load(b, s, &sim);
+  bool ok = true;
+  for (int k = 0; k < len && ok; k++)
+    ok = sim_step(b, s, &sim, sim_move(b, sim.head, path[k]));
+  sim.grow++;
+  if (ok)
+    ok = sim_trail_dist(b, &sim, PLAN_TRAIL_SLACK, deadline_ns) >= 0;
+  sim_unload(b, &sim);
+  return ok;
+}
+
+// No path to take: the cycle move if the trail stays reachable after it (the
+// body drifts onto the cycle that way), else the safe move leaving the trail
+// farthest away. False if no move keeps the trail reachable. This is the
+// safety net, so it is not cut short by the search budget: four searches of
+// at most n_cells each.
+static bool plan_chase(Bot *b, const Snake *s, int head_cell, int apple_cell,
+                       int slack, Dir *out) {
+  const Dir cycle_dir = b->cycle_next_dir[head_cell];
+  int best = -1;
+  const Dir dirs[4] = {DIR_UP, DIR_DOWN, DIR_LEFT, DIR_RIGHT};
+  for (int i = 0; i < 4; i++) {
+    if (s->len > 1 && is_opposite(s->dir, dirs[i]))
+      continue;
+    PlanSim sim;
+    sim_load(b, s, &sim);
+    int c = sim_move(b, head_cell, dirs[i]);
+    bool ok = sim_step(b, s, &sim, c);
+    if (ok && c == apple_cell)
+      sim.grow++;
+    int d = ok ? sim_trail_dist(b, &sim, slack, UINT64_MAX) : -1;
+    sim_unload(b, &sim);
+    if (d >= 0 && dirs[i] == cycle_dir) {
+      *out = cycle_dir;
+      return true;
+    }
+    if (d > best) {
+      best = d;
+      *out = dirs[i];
+    }
+  }
+  return best >= 0;
+}
+
+// Whether the snake can settle onto the cycle from where it is now.
+static bool plan_can_settle(Bot *b, const Snake *s) {
+  PlanSim sim;
+  sim_load(b, s, &sim);
+  bool ok = sim_settles(b, s, &sim);
+  sim_unload(b, &sim);
+  return ok;
+}
+
+// Decides the move while the planner is in charge.
+//  - PLAN_FREE: shortest paths to the apple, taken when plan_accept passes
+//    them. The body ignores the cycle here, which pays while the board is
+//    mostly empty.
+//  - PLAN_SETTLE: from PLAN_SETTLE_FILL on (or earlier, after a while with
+//    no safe path), follow the cycle strictly once that lays the whole body
+//    onto it without a collision. Checked again every tick; if apples eaten
+//    on the way break it, back to PLAN_FREE.
+//  - PLAN_CYCLE: the body is contiguous on the cycle. Bot_OnTick repairs the
+//    cycle toward each apple and the snake follows it strictly: a shortcut
+//    would leave cells behind the head that a later apple lands in, a whole
+//    lap away, which costs more than the shortcut saves.
+static bool plan_next_dir(Bot *b, const Snake *s, const Apple *a, Dir *out) {
+  BotPlan *p = &b->plan;
+  const int w = b->grid_w;
+  IVec2 head = Snake_Head(s);
+  int head_cell = cell_index(w, head.x, head.y);
+  int apple_cell = cell_index(w, a->pos.x, a->pos.y);
+
+  if (p->phase == PLAN_SETTLE) {
+    if (p->run + 1 >= s->len) {
+      p->phase = PLAN_CYCLE;
+    } else if (!plan_can_settle(b, s)) {
+      p->phase = PLAN_FREE;
+      p->len = 0;
+    }
+  }
+  // Past the fill mark no new paths are taken, so the body drifts onto the
+  // cycle until it can settle.
+  const bool full = s->len >= (int)(PLAN_SETTLE_FILL * (double)b->n_cells);
+  if (p->phase == PLAN_FREE && full && plan_can_settle(b, s)) {
+    p->phase = PLAN_SETTLE;
+    p->run = 0;
+  }
+  if (p->phase != PLAN_FREE) {
+    if (p->phase == PLAN_SETTLE)
+      p->run++;
+    *out = b->cycle_next_dir[head_cell];
+    return true;
+  }
+
+  const uint64_t deadline_ns =
+      SDL_GetTicksNS() + (uint64_t)b->tuning.plan_budget_us * 1000u;
+  // A committed path is followed to the end even past the fill mark: only
+  // its end state was checked, not the ones on the way.
+  if (!(p->step < p->len && p->apple_cell == apple_cell &&
+        p->expect_cell == head_cell)) {
+    p->len = 0;
+    p->step = 0;
+  }
+  bool searched = false;
+  if (p->len == 0 && !full) {
+    searched = true;
+    int len = plan_search(b, s, apple_cell, deadline_ns);
+    if (len > 0) {
+      plan_trace(b, apple_cell, p->dirs);
+      if (plan_accept(b, s, p->dirs, len, deadline_ns)) {
+        p->len = len;
+        p->apple_cell = apple_cell;
+        p->n_paths++;
+      }
+    }
+  }
+
+  // Searches that ran out of time don't count as finding nothing.
+  if (p->len > 0)
+    p->stuck = 0;
+  else if (searched && SDL_GetTicksNS() <= deadline_ns)
+    p->stuck++;
+
+  if (p->step < p->len) {
+    *out = p->dirs[p->step++];
+  } else if (p->stuck > b->grid_w + b->grid_h && plan_can_settle(b, s)) {
+    // No safe path to the apple for a while (it sits in a pocket the body
+    // is slow to open): settle rather than wander.
+    p->phase = PLAN_SETTLE;
+    p->run = 1;
+    *out = b->cycle_next_dir[head_cell];
+  } else if (plan_chase(b, s, head_cell, apple_cell, PLAN_TRAIL_SLACK, out) ||
+             plan_chase(b, s, head_cell, apple_cell, 0, out)) {
+    p->n_chase++;
+  } else {
+    // Nothing keeps the trail in reach: let the cycle logic pick a move.
+    p->n_failed++;
+    return false;
+  }
+  p->expect_cell = sim_move(b, head_cell, *out);
+  return true;
+}
+
+// ------------------------------
+// Cycle repair (BOT_MODE_REPAIR)
+// ------------------------------
+
+// Repairs per attempt (each one must shorten the way to the apple), and ticks
+// between attempts while the apple stays put: the moving tail keeps opening
+// new places to splice loops back in.
+#define REPAIR_MAX_PER_TRY 64
+#define REPAIR_RETRY_TICKS 4
+
+// One cycle move, under the same wrap rule build_cycle_mappings checks.
+static bool cycle_step(const Bot *b, IVec2 p, Dir d, IVec2 *out) {
+  if (b->cycle_wrap) {
+    *out = wrap_step(p, d, b->grid_w, b->grid_h);
+    return true;
+  }
+  return step_unwrapped(p, d, b->grid_w, b->grid_h, out);
+}
+
+static void perpendicular_dirs(Dir d, Dir out[2]) {
+  if (d == DIR_LEFT || d == DIR_RIGHT) {
+    out[0] = DIR_UP;
+    out[1] = DIR_DOWN;
+  } else {
+    out[0] = DIR_LEFT;
+    out[1] = DIR_RIGHT;
+  }
+}
+
+// Moves the loop q_idx..s_idx to sit between u_idx and the index after it,
+// entered at y_idx (the loop cell after x_idx, or q_idx when x_idx == s_idx).
+// In 2x2-block terms (botlib's splice_horizontal / splice_vertical): p -> q,
+// s -> r becomes p -> r plus the loop's closing edge s -> q, then loop edge
+// x -> y and u -> v become u -> y, x -> v. Only the indices from q_idx through
+// the old u_idx are rewritten, with no build_cycle_mappings pass. Those cells
+// must be free of the snake: occ_bits is indexed by cycle position and is
+// left as is.
+static void cycle_move_loop(Bot *b, int q_idx, int s_idx, int x_idx,
+                            int u_idx) {
+  const int n = b->n_cells;
+  const int w = b->grid_w;
+  int loop_len = dist_idx(q_idx, s_idx, n) + 1;
+  int main_len = dist_idx(s_idx, u_idx, n);
+  int y_off = (x_idx == s_idx) ? 0 : dist_idx(q_idx, x_idx, n) + 1;
+
+  int k = 0;
+  for (int m = 1; m <= main_len; m++) {
+    int old = (s_idx + m) % n;
+    b->repair_pos[k] = b->pos_of_idx[old];
+    b->repair_visit[k++] = b->last_visit_idx[old];
+  }
+  for (int l = 0; l < loop_len; l++) {
+    int old = (q_idx + (y_off + l) % loop_len) % n;
+    b->repair_pos[k] = b->pos_of_idx[old];
+    b->repair_visit[k++] = b->last_visit_idx[old];
+  }
+  for (int i = 0; i < k; i++) {
+    int idx = (q_idx + i) % n;
+    IVec2 p = b->repair_pos[i];
+    b->pos_of_idx[idx] = p;
+    b->cycle_index[cell_index(w, p.x, p.y)] = idx;
+    b->last_visit_idx[idx] = b->repair_visit[i];
+  }
+  // Moves change from p (just before q_idx) through x (just before v).
+  for (int i = -1; i < k; i++) {
+    int idx = (q_idx + i + n) % n;
+    IVec2 p = b->pos_of_idx[idx];
+    Dir d = dir_from_to_wrap(p, b->pos_of_idx[b->next_cycle_idx[idx]], w,
+                             b->grid_h);
+    b->cycle_next_dir[cell_index(w, p.x, p.y)] = d;
+    b->cycle_dirs[idx] = d;
+  }
+  b->n_repairs++;
+}
+
+// Finds a free cycle edge u -> v at keys [k_lo, gap) running beside loop edge
+// x -> y in a 2x2 block (antiparallel, so the two can be spliced). Returns
+// u's index or -1.
+static int repair_splice_partner(const Bot *b, int x_idx, int y_idx,
+                                 int head_idx, int k_lo, int gap) {
+  const int n = b->n_cells;
+  const int w = b->grid_w;
+  IVec2 px = b->pos_of_idx[x_idx];
+  IVec2 py = b->pos_of_idx[y_idx];
+  Dir sides[2];
+  perpendicular_dirs(dir_from_to_wrap(px, py, w, b->grid_h), sides);
+  for (int j = 0; j < 2; j++) {
+    IVec2 pv, pu;
+    if (!cycle_step(b, px, sides[j], &pv) || !cycle_step(b, py, sides[j], &pu))
+      continue;
+    int u_idx = b->cycle_index[cell_index(w, pu.x, pu.y)];
+    int v_idx = b->cycle_index[cell_index(w, pv.x, pv.y)];
+    int k_u = dist_idx(head_idx, u_idx, n);
+    if (b->next_cycle_idx[u_idx] == v_idx && k_u >= k_lo && k_u < gap)
+      return u_idx;
+  }
+  return -1;
+}
+
+// Shortens the cycle from the head to the apple. A Hamiltonian cycle in the
+// plane runs the two parallel sides of any 2x2 block it uses in opposite
+// directions, so one block swap always splits it in two; this takes two:
+// split a loop q..s off the free stretch before the apple at one block
+// (p -> q, s -> r), then splice it back in after the apple at another (loop
+// edge x -> y beside u -> v). The apple comes up loop-length cells sooner, the
+// loop keeps its direction and the body keeps its cycle indices, so cycle
+// following stays as safe as before.
+//
+// Keys count cycle steps from the head. One pass marks the keys whose edge to
+// the next key has a splice partner past the apple, and prefix counts of those
+// let every split block be checked in O(1), so the longest movable loop is
+// found in O(apple key). Returns true if the cycle changed.
+static bool repair_toward_apple(Bot *b, const Apple *a, int head_idx,
+                                int tail_idx, int gap) {
+  const int n = b->n_cells;
+  const int w = b->grid_w;
+  int apple_cell = cell_index(w, a->pos.x, a->pos.y);
+  int k_p = dist_idx(head_idx, b->cycle_index[apple_cell], n);
+  if (k_p < 3 || k_p > gap)
+    return false;
+
+  // marks[k]: edges with a splice partner among keys 1..k-1.
+  int *marks = b->repair_marks;
+  marks[0] = 0;
+  marks[1] = 0;
+  for (int k = 1; k + 1 < k_p; k++) {
+    int x_idx = (head_idx + k) % n;
+    bool ok = repair_splice_partner(b, x_idx, b->next_cycle_idx[x_idx],
+                                    head_idx, k_p, gap) >= 0;
+    marks[k + 1] = marks[k] + (ok ? 1 : 0);
+  }
+
+  int best_len = 0;
+  int best_q = -1, best_s = -1, best_x = -1, best_u = -1;
+  for (int k = 0; k + 2 < k_p; k++) {
+    int p_idx = (head_idx + k) % n;
+    int q_idx = b->next_cycle_idx[p_idx];
+    IVec2 pp = b->pos_of_idx[p_idx];
+    IVec2 pq = b->pos_of_idx[q_idx];
+    Dir sides[2];
+    perpendicular_dirs(b->cycle_next_dir[cell_index(w, pp.x, pp.y)], sides);
+    for (int i = 0; i < 2; i++) {
+      IVec2 pr, ps;
+      if (!cycle_step(b, pp, sides[i], &pr) ||
+          !cycle_step(b, pq, sides[i], &ps))
+        continue;
+      int r_idx = b->cycle_index[cell_index(w, pr.x, pr.y)];
+      int s_idx = b->cycle_index[cell_index(w, ps.x, ps.y)];
+      if (b->next_cycle_idx[s_idx] != r_idx)
+        continue;
+      int k_s = dist_idx(head_idx, s_idx, n);
+      if (k_s <= k + 1 || k_s >= k_p || k_s - k <= best_len)
+        continue;
+
+      // A splice point on the loop: an inner edge (keys k+1 .. k_s-1 to the
+      // next key) or the closing edge s -> q.
+      int x_idx = -1;
+      int u_idx = -1;
+      if (marks[k_s] - marks[k + 1] > 0) {
+        for (int kx = k + 1; kx < k_s && u_idx < 0; kx++) {
+          x_idx = (head_idx + kx) % n;
+          u_idx = repair_splice_partner(b, x_idx, b->next_cycle_idx[x_idx],
+                                        head_idx, k_p, gap);
+        }
+      } else {
+        x_idx = s_idx;
+        u_idx = repair_splice_partner(b, s_idx, q_idx, head_idx, k_p, gap);
+      }
+      if (u_idx < 0)
+        continue;
+      best_len = k_s - k;
+      best_q = q_idx;
+      best_s = s_idx;
+      best_x = x_idx;
+      best_u = u_idx;
+    }
+  }
+  if (best_len == 0)
+    return false;
+  // Keys up to gap are free in a cycle-ordered body; check anyway, since the
+  // move keeps occ_bits as is.
+  int v_idx = b->next_cycle_idx[best_u];
+  if (!corridor_clear(b, head_idx, v_idx, tail_idx, false, n, n))
+    return false;
+  cycle_move_loop(b, best_q, best_s, best_x, best_u);
+  return true;
+}
+
+// ------------------------------
+// Lookahead (per-tick budget)
+// ------------------------------
+
+#define LOOK_APPLE (1 << 30)
+#define LOOK_DEAD (-(1 << 30))
+#define LOOK_DELTAS (2 * BOT_LOOKAHEAD_MAX_DEPTH)
+
+// The snake a few ticks ahead as a copy-on-write view of the real one: cell
+// counts are read from the snake, and the view's own head pushes / tail pops
+// are a short list of per-cell deltas that the search undoes on the way back.
+typedef struct LookView {
+  const Bot *b;
+  const Snake *s;
+  int apple_cell, apple_idx;
+  int cell[LOOK_DELTAS];
+  int delta[LOOK_DELTAS];
+  int n_delta;
+  int path[BOT_LOOKAHEAD_MAX_DEPTH]; // head cells entered, oldest first
+  int n_path;
+  int popped; // tail segments dropped: the real body first, then the path
+  int grow;   // growth still pending
+  int len;
+  uint64_t nodes, deadline_ns;
+  bool out_of_time;
+} LookView;
+
+static int look_occ(const LookView *v, int cell) {
+  int c = v->s->occ[cell];
+  for (int i = 0; i < v->n_delta; i++) {
+    if (v->cell[i] == cell)
+      c += v->delta[i];
+  }
+  return c;
+}
+
+static int look_tail_cell(const LookView *v) {
+  const Snake *s = v->s;
+  if (v->popped < s->len) {
+    IVec2 t = Snake_Seg(s, s->len - 1 - v->popped);
+    return cell_index(v->b->grid_w, t.x, t.y);
+  }
+  return v->path[v->popped - s->len];
+}
+
+// One tick of the view: the tail drops unless growth is pending (as in
+// Snake_Tick), then the head enters cell.
+static void look_push(LookView *v, int cell) {
+  if (v->grow > 0) {
+    v->grow--;
+    v->len++;
+  } else {
+    v->cell[v->n_delta] = look_tail_cell(v);
+    v->delta[v->n_delta++] = -1;
+    v->popped++;
+  }
+  v->cell[v->n_delta] = cell;
+  v->delta[v->n_delta++] = 1;
+  v->path[v->n_path++] = cell;
+}
+
+// The greedy safety gates, applied to the view. Cells the view has vacated
+// still block the corridor of a shortcut (base occ_bits are not copied), so
+// this errs toward refusing moves.
+static bool look_move_ok(const LookView *v, IVec2 head, int head_idx, Dir dir,
+                         Dir cand_dir, IVec2 *out) {
+  const Bot *b = v->b;
+  const int n = b->n_cells;
+  if (v->len > 1 && is_opposite(dir, cand_dir))
+    return false;
+  IVec2 p = wrap_step(head, cand_dir, b->grid_w, b->grid_h);
+  int cell = cell_index(b->grid_w, p.x, p.y);
+  int target = b->cycle_index[cell];
+  if (target < 0)
+    return false;
+
+  int tail_cell = look_tail_cell(v);
+  int occ = look_occ(v, cell);
+  if (v->grow == 0 && cell == tail_cell)
+    occ--;
+  if (occ > 0)
+    return false;
+
+  int gap = n - 1;
+  if (v->len > 1)
+    gap = dist_idx(head_idx, b->cycle_index[tail_cell], n) - 1;
+  if (gap < 0)
+    gap = 0;
+  int d = dist_idx(head_idx, target, n);
+  if (d < 1 || d > max_skip_for(b, gap, v->len))
+    return false;
+  if (d > 1) {
+    if (dist_idx(head_idx, v->apple_idx, n) <= d)
+      return false;
+    if (!corridor_clear(b, head_idx, target, -1, false, n, d))
+      return false;
+    for (int i = 0; i < v->n_path; i++) {
+      int k = dist_idx(head_idx, b->cycle_index[v->path[i]], n);
+      if (k >= 1 && k <= d)
+        return false;
+    }
+  }
+  *out = p;
+  return true;
+}
+
+static int look_free_neighbors(const LookView *v, IVec2 pos) {
+  const Bot *b = v->b;
+  int count = 0;
+  const IVec2 dirs[4] = {{0, -1}, {0, 1}, {-1, 0}, {1, 0}};
+  for (int i = 0; i < 4; i++) {
+    IVec2 q = (IVec2){pos.x + dirs[i].x, pos.y + dirs[i].y};
+    if (q.x < 0 || q.x >= b->grid_w || q.y < 0 || q.y >= b->grid_h)
+      continue;
+    if (look_occ(v, cell_index(b->grid_w, q.x, q.y)) == 0)
+      count++;
+  }
+  return count;
+}
+
+static int look_value(LookView *v, IVec2 head, Dir dir, int depth, int t);
+
+// Value of moving the view's head to p (already checked) at tick t, with
+// depth ticks of lookahead counting this one. Higher is better: reaching the
+// apple sooner, else dying later, else ending closer to it along the cycle.
+static int look_child(LookView *v, IVec2 p, Dir d, int depth, int t) {
+  const Bot *b = v->b;
+  int cell = cell_index(b->grid_w, p.x, p.y);
+  if (cell == v->apple_cell)
+    return LOOK_APPLE - (t + 1);
+
+  const int n_delta = v->n_delta, n_path = v->n_path;
+  const int popped = v->popped, grow = v->grow, len = v->len;
+  look_push(v, cell);
+  int val;
+  if (v->len > 6 && look_free_neighbors(v, p) <= 1)
+    val = LOOK_DEAD + t + 1;
+  else
+    val = look_value(v, p, d, depth - 1, t + 1);
+  v->n_delta = n_delta;
+  v->n_path = n_path;
+  v->popped = popped;
+  v->grow = grow;
+  v->len = len;
+  return val;
+}
+
+static int look_value(LookView *v, IVec2 head, Dir dir, int depth, int t) {
+  const Bot *b = v->b;
+  int head_idx = b->cycle_index[cell_index(b->grid_w, head.x, head.y)];
+  if ((++v->nodes & 63) == 0 && SDL_GetTicksNS() > v->deadline_ns)
+    v->out_of_time = true;
+  if (v->out_of_time)
+    return 0;
+  if (depth == 0)
+    return -dist_idx(head_idx, v->apple_idx, b->n_cells);
+
+  const Dir dirs[4] = {DIR_UP, DIR_DOWN, DIR_LEFT, DIR_RIGHT};
+  int best = LOOK_DEAD + t;
+  for (int i = 0; i < 4; i++) {
+    IVec2 p;
+    if (!look_move_ok(v, head, head_idx, dir, dirs[i], &p))
+      continue;
+    int val = look_child(v, p, dirs[i], depth, t);
+    if (v->out_of_time)
+      return 0;
+    if (val > best)
+      best = val;
+  }
+  return best;
+}
+
+// Re-rank the greedy-safe candidates by iterative deepening until the
+// deadline; ties keep the greedy order. Returns false (keep the greedy pick)
+// if not even depth 1 finished in time.
+static bool look_choose(Bot *b, const Snake *s, const Apple *a,
+                        const Dir *cand, const double *score, int n_cand,
+                        uint64_t deadline_ns, Dir *out) {
+  int apple_cell = cell_index(b->grid_w, a->pos.x, a->pos.y);
+  LookView v = {.b = b,
+                .s = s,
+                .apple_cell = apple_cell,
+                .apple_idx = b->cycle_index[apple_cell],
+                .grow = s->grow,
+                .len = s->len,
+                .deadline_ns = deadline_ns};
+  if (v.apple_idx < 0)
+    return false;
+
+  IVec2 head = Snake_Head(s);
+  int chosen = -1;
+  int completed = 0;
+  for (int depth = 1; depth <= b->tuning.lookahead_depth; depth++) {
+    int best = 0;
+    int best_i = -1;
+    for (int i = 0; i < n_cand && !v.out_of_time; i++) {
+      IVec2 p = wrap_step(head, cand[i], b->grid_w, b->grid_h);
+      int val = look_child(&v, p, cand[i], depth, 0);
+      if (best_i < 0 || val > best ||
+          (val == best && score[i] > score[best_i])) {
+        best = val;
+        best_i = i;
+      }
+    }
+    if (v.out_of_time)
+      break;
+    chosen = best_i;
+    completed = depth;
+    // Deeper searches cannot change an apple already reached or a death
+    // every candidate runs into.
+    if (best >= LOOK_APPLE - depth || best <= LOOK_DEAD + depth)
+      break;
+  }
+
+  b->n_lookahead++;
+  b->lookahead_depth_sum += (uint64_t)completed;
+  if (v.out_of_time)
+    b->n_budget_exhausted++;
+  if (chosen < 0)
+    return false;
+  *out = cand[chosen];
+  return true;
+}
+
 // ------------------------------
 // Hamiltonian cycle generation
 // ------------------------------
@@ -416,7 +1408,7 @@ static bool build_cycle_mappings(Bot *b) {
   return true;
 }
 
-bool Bot_Init(Bot *b, int grid_w, int grid_h) {
+static bool bot_alloc(Bot *b, int grid_w, int grid_h) {
   if (!b)
     return false;
   memset(b, 0, sizeof(*b));
@@ -431,11 +1423,26 @@ bool Bot_Init(Bot *b, int grid_w, int grid_h) {
   b->pos_of_idx = (IVec2 *)malloc((size_t)b->n_cells * sizeof(IVec2));
   b->next_cycle_idx = (int *)malloc((size_t)b->n_cells * sizeof(int));
   b->cycle_dirs = (Dir *)malloc((size_t)b->n_cells * sizeof(Dir));
-  b->occupied_idx = (uint8_t *)malloc((size_t)b->n_cells);
   b->last_visit_idx = (int *)malloc((size_t)b->n_cells * sizeof(int));
+  b->occ_bits = (uint64_t *)calloc((size_t)(b->n_cells + 63) >> 6,
+                                   sizeof(uint64_t));
+  BotPlan *p = &b->plan;
+  p->dist = (int *)malloc((size_t)b->n_cells * sizeof(int));
+  p->seen = (uint32_t *)calloc((size_t)b->n_cells, sizeof(uint32_t));
+  p->bfs = (int *)malloc((size_t)b->n_cells * sizeof(int));
+  p->queue = (int *)malloc((size_t)(b->n_cells + 1) * sizeof(int));
+  p->from = (uint8_t *)malloc((size_t)b->n_cells);
+  p->seg = (int *)malloc((size_t)b->n_cells * sizeof(int));
+  p->occ = (uint8_t *)calloc((size_t)b->n_cells, 1);
+  p->dirs = (Dir *)malloc((size_t)b->n_cells * sizeof(Dir));
+  b->repair_pos = (IVec2 *)malloc((size_t)b->n_cells * sizeof(IVec2));
+  b->repair_visit = (int *)malloc((size_t)b->n_cells * sizeof(int));
+  b->repair_marks = (int *)malloc((size_t)(b->n_cells + 1) * sizeof(int));
   if (!b->cycle_next_dir || !b->cycle_index || !b->cycle_dirs ||
-      !b->occupied_idx || !b->last_visit_idx || !b->pos_of_idx ||
-      !b->next_cycle_idx) {
+      !b->last_visit_idx || !b->pos_of_idx || !b->next_cycle_idx ||
+      !b->occ_bits || !p->dist || !p->seen || !p->bfs || !p->queue ||
+      !p->from || !p->seg || !p->occ || !p->dirs || !b->repair_pos ||
+      !b->repair_visit || !b->repair_marks) {
     Bot_Destroy(b);
     return false;
   }
@@ -448,6 +1455,12 @@ bool Bot_Init(Bot *b, int grid_w, int grid_h) {
   b->tuning = clamp_tuning(&b->tuning);
   for (int i = 0; i < b->n_cells; i++)
     b->last_visit_idx[i] = INT_MIN / 2;
+  return true;
+}
+
+bool Bot_Init(Bot *b, int grid_w, int grid_h) {
+  if (!bot_alloc(b, grid_w, grid_h))
+    return false;
 
   build_serpentine_cycle(b);
   if (!build_cycle_mappings(b)) {
@@ -464,157 +1477,44 @@ void Bot_SetTuning(Bot *b, const BotTuning *t) {
   b->tuning = clamp_tuning(t);
 }
 
-bool Bot_LoadCycleFromFile(Bot *b, const char *path) {
-  if (!b || !path)
+static bool set_cycle(Bot *b, const CycleFile *cf) {
+  if (!cf->dirs || cf->meta.width != b->grid_w ||
+      cf->meta.height != b->grid_h)
     return false;
 
-  if (strlen(path) < 6 || strcmp(path + strlen(path) - 6, ".cycle") != 0)
-    return false;
-
-  FILE *f = fopen(path, "rb");
-  if (!f)
-    return false;
-
-  fseek(f, 0, SEEK_END);
-  long sz = ftell(f);
-  fseek(f, 0, SEEK_SET);
-  if (sz <= 0) {
-    fclose(f);
-    return false;
-  }
-
-  char *buf = (char *)malloc((size_t)sz + 1);
-  if (!buf) {
-    fclose(f);
-    return false;
-  }
-  size_t got = fread(buf, 1, (size_t)sz, f);
-  fclose(f);
-  buf[got] = '\0';
-
-  char *p = buf;
-  while (*p == '\r' || *p == '\n' || *p == ' ' || *p == '\t')
-    p++;
-  char *line_end = strpbrk(p, "\r\n");
-  if (!line_end) {
-    free(buf);
-    return false;
-  }
-  *line_end = '\0';
-  if (strcmp(p, "SNAKECYCLE 1") != 0) {
-    free(buf);
-    return false;
-  }
-
-  int meta_w = -1;
-  int meta_h = -1;
-  int meta_wrap = -1;
-  bool have_data = false;
-  char *data_start = NULL;
-
-  p = line_end + 1;
-  while (*p) {
-    while (*p == '\r' || *p == '\n')
-      p++;
-    if (!*p)
-      break;
-
-    char *e = strpbrk(p, "\r\n");
-    if (e)
-      *e = '\0';
-
-    char *s = p;
-    while (*s == ' ' || *s == '\t')
-      s++;
-
-    if (*s == '\0' || *s == '#') {
-      // skip
-    } else if (strcmp(s, "DATA") == 0) {
-      have_data = true;
-      data_start = e ? (e + 1) : (p + strlen(p));
-      break;
-    } else {
-      char *eq = strchr(s, '=');
-      if (eq) {
-        *eq = '\0';
-        char *key = s;
-        char *val = eq + 1;
-        while (*val == ' ' || *val == '\t')
-          val++;
-        int iv = atoi(val);
-        if (strcmp(key, "width") == 0)
-          meta_w = iv;
-        else if (strcmp(key, "height") == 0)
-          meta_h = iv;
-        else if (strcmp(key, "wrap") == 0)
-          meta_wrap = iv;
-      }
-    }
+  for (int i = 0; i < b->n_cells; i++)
+    b->cycle_next_dir[i] = (Dir)cf->dirs[i];
 
-    if (!e)
-      break;
-    p = e + 1;
-  }
+  b->cycle_pos = -1;
+  if (cf->meta.wrap >= 0)
+    b->cycle_wrap = (cf->meta.wrap != 0);
+  else
+    b->cycle_wrap = ((b->grid_w & 1) && (b->grid_h & 1));
+  return build_cycle_mappings(b);
+}
 
-  if (!have_data || !data_start) {
-    free(buf);
+bool Bot_InitFromCycle(Bot *b, const CycleFile *cf) {
+  if (!b || !cf)
     return false;
-  }
-  if (meta_w != -1 && meta_w != b->grid_w) {
-    free(buf);
+  if (!bot_alloc(b, cf->meta.width, cf->meta.height))
     return false;
-  }
-  if (meta_h != -1 && meta_h != b->grid_h) {
-    free(buf);
+  if (!set_cycle(b, cf)) {
+    Bot_Destroy(b);
     return false;
   }
+  return true;
+}
 
-  int need = b->n_cells;
-  int have = 0;
-  for (char *q = data_start; *q && have < need; q++) {
-    char c = *q;
-    Dir d = DIR_UP;
-    bool ok = true;
-    switch (c) {
-    case 'U':
-    case 'u':
-      d = DIR_UP;
-      break;
-    case 'D':
-    case 'd':
-      d = DIR_DOWN;
-      break;
-    case 'L':
-    case 'l':
-      d = DIR_LEFT;
-      break;
-    case 'R':
-    case 'r':
-      d = DIR_RIGHT;
-      break;
-    default:
-      ok = false;
-      break;
-    }
-    if (!ok)
-      continue;
-    b->cycle_next_dir[have] = d;
-    have++;
-  }
-
-  free(buf);
-  if (have != need)
+bool Bot_LoadCycleFromFile(Bot *b, const char *path) {
+  if (!b || !path)
     return false;
 
-  b->cycle_pos = -1;
-  if (meta_wrap >= 0)
-    b->cycle_wrap = (meta_wrap != 0);
-  else
-    b->cycle_wrap = ((b->grid_w & 1) && (b->grid_h & 1));
-  if (!build_cycle_mappings(b))
+  CycleFile cf;
+  if (!CycleFile_Load(&cf, path, NULL, 0))
     return false;
-
-  return true;
+  bool ok = set_cycle(b, &cf);
+  CycleFile_Free(&cf);
+  return ok;
 }
 
 void Bot_Destroy(Bot *b) {
@@ -625,11 +1525,28 @@ void Bot_Destroy(Bot *b) {
   free(b->pos_of_idx);
   free(b->next_cycle_idx);
   free(b->cycle_dirs);
-  free(b->occupied_idx);
   free(b->last_visit_idx);
+  free(b->occ_bits);
+  free(b->plan.dist);
+  free(b->plan.seen);
+  free(b->plan.bfs);
+  free(b->plan.queue);
+  free(b->plan.from);
+  free(b->plan.seg);
+  free(b->plan.occ);
+  free(b->plan.dirs);
+  free(b->repair_pos);
+  free(b->repair_visit);
+  free(b->repair_marks);
   memset(b, 0, sizeof(*b));
 }
 
+void Bot_Reset(Bot *b) {
+  if (!b)
+    return;
+  b->cycle_pos = -1;
+}
+
 void Bot_OnTick(Bot *b, Snake *s, const Apple *a) {
   if (!b || !s || !a)
     return;
@@ -639,55 +1556,66 @@ void Bot_OnTick(Bot *b, Snake *s, const Apple *a) {
 
   if (b->n_cells <= 0)
     return;
+  const bool timed = b->tuning.tick_budget_us > 0 || b->time_decisions;
+  const uint64_t start_ns = timed ? SDL_GetTicksNS() : 0;
 
-  // Refresh occupancy each tick (O(L) where L is snake length) for safety checks.
-  memset(b->occupied_idx, 0, (size_t)b->n_cells);
-  for (int i = 0; i < s->len; i++) {
-    int seg_i = cell_index(b->grid_w, s->seg[i].x, s->seg[i].y);
-    int idx = b->cycle_index[seg_i];
-    if (idx >= 0 && idx < b->n_cells)
-      b->occupied_idx[idx] = 1;
-  }
-
-  IVec2 head = s->seg[0];
+  IVec2 head = Snake_Head(s);
   int head_i = cell_index(b->grid_w, head.x, head.y);
   int pos = b->cycle_index[head_i];
   if (pos < 0)
     return;
 
-  int tail_i = cell_index(b->grid_w, s->seg[s->len - 1].x,
-                          s->seg[s->len - 1].y);
+  IVec2 tail = Snake_Tail(s);
+  int tail_i = cell_index(b->grid_w, tail.x, tail.y);
   int tail_idx = b->cycle_index[tail_i];
+  if (b->cycle_pos < 0) {
+    plan_clear(&b->plan);
+    b->repair_apple = -1;
+  }
+  occ_sync(b, s, head_i, tail_i);
+  b->cycle_pos = pos;
+
   int gap = dist_idx(pos, tail_idx, b->n_cells) - 1;
   if (s->len == 1)
     gap = b->n_cells - 1;
   if (gap < 0)
     gap = 0;
 
-  double aggression = 1.0 - ((double)s->len / (double)b->n_cells);
-  aggression *= b->tuning.aggression_scale;
-  aggression = clampd(aggression, 0.0, 1.0);
-
-  int max_skip = 1;
-  if (gap > 1) {
-    int extra = (int)(aggression * (double)(gap - 1));
-    if (extra < 0)
-      extra = 0;
-    max_skip += extra;
+  // Each repair search is O(apple key), so it runs when an apple appears and
+  // then every few ticks rather than every tick.
+  int apple_cell = cell_index(b->grid_w, a->pos.x, a->pos.y);
+  bool repairing = b->tuning.mode == BOT_MODE_REPAIR;
+  int retry = REPAIR_RETRY_TICKS;
+  if (b->tuning.mode == BOT_MODE_PLAN && b->plan.phase == PLAN_CYCLE) {
+    int apple_key = dist_idx(pos, b->cycle_index[apple_cell], b->n_cells);
+    repairing = true;
+    retry = clampi(apple_key / PLAN_REPAIR_RETRIES, REPAIR_RETRY_TICKS,
+                   b->n_cells);
+  }
+  if (repairing &&
+      (b->repair_apple != apple_cell || b->tick % retry == 0)) {
+    b->repair_apple = apple_cell;
+    for (int r = 0; r < REPAIR_MAX_PER_TRY &&
+                    repair_toward_apple(b, a, pos, tail_idx, gap);
+         r++) {
+    }
   }
-  if (b->tuning.max_skip_cap > 0 && max_skip > b->tuning.max_skip_cap)
-    max_skip = b->tuning.max_skip_cap;
-  if (gap > 0 && max_skip > gap)
-    max_skip = gap;
-  if (max_skip < 1)
-    max_skip = 1;
+
+  int max_skip = max_skip_for(b, gap, s->len);
 
   Dir best_dir = b->cycle_next_dir[head_i];
   double best_score = -1e9;
   bool have_choice = false;
+  bool planned =
+      b->tuning.mode == BOT_MODE_PLAN && plan_next_dir(b, s, a, &best_dir);
+
+  // Safe candidates, kept for the lookahead to re-rank.
+  Dir cand[4];
+  double cand_score[4];
+  int n_cand = 0;
 
   const Dir dirs[4] = {DIR_UP, DIR_DOWN, DIR_LEFT, DIR_RIGHT};
-  for (int i = 0; i < 4; i++) {
+  for (int i = 0; i < 4 && !planned; i++) {
     Dir cand_dir = dirs[i];
     if (s->len > 1 && is_opposite(s->dir, cand_dir))
       continue;
@@ -700,7 +1628,7 @@ void Bot_OnTick(Bot *b, Snake *s, const Apple *a) {
 
     bool will_grow = (cand_pos.x == a->pos.x && cand_pos.y == a->pos.y);
     bool tail_free = !will_grow;
-    if (is_occupied_idx(b, target, tail_idx, tail_free))
+    if (is_occupied_idx(b, s, target, tail_idx, tail_free))
       continue;
 
     int d = dist_idx(pos, target, b->n_cells);
@@ -710,8 +1638,12 @@ void Bot_OnTick(Bot *b, Snake *s, const Apple *a) {
                         max_skip))
       continue;
 
-    double score = score_move(b, &b->tuning, pos, tail_idx, target, gap,
-                              max_skip, s->len, cand_pos, a, tail_free, d);
+    double score = score_move(b, s, &b->tuning, pos, tail_idx, target, gap,
+                              max_skip, cand_pos, a, tail_free, d);
+    if (score <= -1e9)
+      continue;
+    cand[n_cand] = cand_dir;
+    cand_score[n_cand++] = score;
     if (score > best_score) {
       best_score = score;
       best_dir = cand_dir;
@@ -719,13 +1651,28 @@ void Bot_OnTick(Bot *b, Snake *s, const Apple *a) {
     }
   }
 
-  if (!have_choice) {
+  if (b->tuning.tick_budget_us > 0 && n_cand > 1) {
+    look_choose(b, s, a, cand, cand_score, n_cand,
+                start_ns + (uint64_t)b->tuning.tick_budget_us * 1000u,
+                &best_dir);
+  }
+
+  if (!have_choice && !planned) {
     // No safe shortcut; fall back to the Hamiltonian ordering.
     int next_idx = b->next_cycle_idx[pos];
     IVec2 next_pos = b->pos_of_idx[next_idx];
     best_dir = dir_from_to_wrap(head, next_pos, b->grid_w, b->grid_h);
   }
 
+  if (timed) {
+    uint64_t spent = SDL_GetTicksNS() - start_ns;
+    b->n_decisions++;
+    b->decide_ns_total += spent;
+    if (spent > b->decide_ns_max)
+      b->decide_ns_max = spent;
+    Histogram_Record(&b->decide_time, spent);
+  }
+
   IVec2 best_pos;
   bool have_best_pos = true;
   best_pos = wrap_step(head, best_dir, b->grid_w, b->grid_h);
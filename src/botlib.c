@@ -1,12 +1,22 @@
 #include "botlib.h"
+#include "cycle_file.h"
 
 #include <ctype.h>
+#include <limits.h>
+#include <stddef.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <stdint.h>
 #include <stdbool.h>
 
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <unistd.h>
+#endif
+
 typedef struct { int x, y; } IVec2;
 
 typedef enum {
@@ -29,6 +39,93 @@ static void set_err(char *err, int err_len, const char *msg) {
   snprintf(err, (size_t)err_len, "%s", msg ? msg : "");
 }
 
+// ------------------------------------------------------------
+// Workspace
+// ------------------------------------------------------------
+
+// Every scratch array the generator/validator needs is carved from one
+// block, so board size is bounded only by memory. The *_ws variants take
+// that block from the caller and never touch the heap; the plain entry
+// points get it from call_ws_alloc.
+//
+// Per cell: direction letter (1) + successor (4) + int scratch (4) +
+// byte scratch (1) + tour treap links and labels (6 x 4). Each of the ten
+// arrays may need an alignment pad, hence the slack.
+#define WS_ALIGN 16
+#define WS_BYTES_PER_CELL 34
+#define WS_SLACK (10 * WS_ALIGN)
+
+typedef struct Workspace {
+  char *dirs;     // n direction letters
+  int *next;      // n successor indices
+  int *ints;      // n ints of scratch (maze stack, in-degrees)
+  uint8_t *bytes; // n bytes of scratch (visited flags)
+  int *tl;        // n treap left children (scramble_cycle)
+  int *tr;        // n treap right children
+  int *tp;        // n treap parents
+  int *tsz;       // n treap subtree sizes
+  int *tnode;     // n cell -> treap node
+  int *tcell;     // n treap node -> cell
+} Workspace;
+
+// Cell count for w x h, or -1 if non-positive or it overflows int.
+static int cell_count(int w, int h) {
+  if (w <= 0 || h <= 0)
+    return -1;
+  if (w > INT_MAX / h)
+    return -1;
+  return w * h;
+}
+
+// Rounded to WS_ALIGN so back-to-back workspaces stay aligned.
+static long long ws_size_for(int n) {
+  long long bytes = (long long)n * WS_BYTES_PER_CELL + WS_SLACK;
+  return (bytes + (WS_ALIGN - 1)) & ~(long long)(WS_ALIGN - 1);
+}
+
+static unsigned char *ws_carve(unsigned char **cur, size_t bytes) {
+  uintptr_t p = (uintptr_t)*cur;
+  p = (p + (WS_ALIGN - 1)) & ~(uintptr_t)(WS_ALIGN - 1);
+  *cur = (unsigned char *)p + bytes;
+  return (unsigned char *)p;
+}
+
+// Lays out a Workspace for n cells inside buf. Returns 0 on success.
+static int ws_bind(int n, void *buf, long long buf_len, Workspace *ws,
+                   char *err, int err_len) {
+  if (!buf) {
+    set_err(err, err_len, "workspace buffer is required");
+    return 1;
+  }
+  if (buf_len < ws_size_for(n)) {
+    set_err(err, err_len,
+            "workspace too small (see snakebot_workspace_size)");
+    return 2;
+  }
+  unsigned char *cur = (unsigned char *)buf;
+  ws->dirs = (char *)ws_carve(&cur, (size_t)n);
+  ws->next = (int *)ws_carve(&cur, (size_t)n * sizeof(int));
+  ws->ints = (int *)ws_carve(&cur, (size_t)n * sizeof(int));
+  ws->bytes = ws_carve(&cur, (size_t)n);
+  ws->tl = (int *)ws_carve(&cur, (size_t)n * sizeof(int));
+  ws->tr = (int *)ws_carve(&cur, (size_t)n * sizeof(int));
+  ws->tp = (int *)ws_carve(&cur, (size_t)n * sizeof(int));
+  ws->tsz = (int *)ws_carve(&cur, (size_t)n * sizeof(int));
+  ws->tnode = (int *)ws_carve(&cur, (size_t)n * sizeof(int));
+  ws->tcell = (int *)ws_carve(&cur, (size_t)n * sizeof(int));
+  return 0;
+}
+
+// The entry points without a workspace argument allocate one per call and
+// free it before returning. Nothing is shared between calls, so every entry
+// point is reentrant and safe to call from many threads at once.
+static void *call_ws_alloc(int n, char *err, int err_len) {
+  void *buf = malloc((size_t)ws_size_for(n));
+  if (!buf)
+    set_err(err, err_len, "out of memory allocating workspace");
+  return buf;
+}
+
 static int parse_cycle_type(const char *name, CycleType *out, char *err,
                             int err_len) {
   if (!out) {
@@ -366,16 +463,12 @@ static void splice_vertical(int w, int i, int j, int *next) {
   set_next_idx(w, next, tlDx, tlDy, blUx, blUy);
 }
 
+// Uses ws->bytes (visited) and ws->ints (DFS stack); mw*mh <= n/4.
 static void build_maze_splices(int mw, int mh, int w, int *next,
-                               unsigned int seed) {
+                               unsigned int seed, const Workspace *ws) {
   int total = mw * mh;
-  uint8_t *vis = (uint8_t *)malloc((size_t)total);
-  int *stack = (int *)malloc((size_t)total * sizeof(int));
-  if (!vis || !stack) {
-    free(vis);
-    free(stack);
-    return;
-  }
+  uint8_t *vis = ws->bytes;
+  int *stack = ws->ints;
   memset(vis, 0, (size_t)total);
 
   Rng rng = {seed ? seed : 0xC0FFEEU};
@@ -429,9 +522,6 @@ static void build_maze_splices(int mw, int mh, int w, int *next,
     if (!advanced)
       sp--;
   }
-
-  free(vis);
-  free(stack);
 }
 
 static void stitch_odd_col(int w, int h, int *next) {
@@ -485,15 +575,12 @@ static int stitch_corner_odd_odd(int w, int h, int *next) {
   return 1;
 }
 
-static int verify_cycle(const int *next, int w, int h, bool wrap) {
+// Uses ws->ints (in-degrees) and ws->bytes (visited).
+static int verify_cycle(const int *next, int w, int h, bool wrap,
+                        const Workspace *ws) {
   int n = w * h;
-  int *indeg = (int *)malloc((size_t)n * sizeof(int));
-  uint8_t *vis = (uint8_t *)malloc((size_t)n);
-  if (!indeg || !vis) {
-    free(indeg);
-    free(vis);
-    return 0;
-  }
+  int *indeg = ws->ints;
+  uint8_t *vis = ws->bytes;
   for (int i = 0; i < n; i++) {
     indeg[i] = 0;
     vis[i] = 0;
@@ -502,71 +589,44 @@ static int verify_cycle(const int *next, int w, int h, bool wrap) {
     for (int x = 0; x < w; x++) {
       int idx = cell_idx(w, x, y);
       int ni = next[idx];
-      if (ni < 0 || ni >= n) {
-        free(indeg);
-        free(vis);
+      if (ni < 0 || ni >= n)
         return 0;
-      }
       IVec2 a = {x, y};
       IVec2 b = {ni % w, ni / w};
       if (wrap) {
-        if (!is_adjacent_wrap(a, b, w, h)) {
-          free(indeg);
-          free(vis);
+        if (!is_adjacent_wrap(a, b, w, h))
           return 0;
-        }
       } else {
-        if (!is_adjacent_nonwrap(a, b)) {
-          free(indeg);
-          free(vis);
+        if (!is_adjacent_nonwrap(a, b))
           return 0;
-        }
       }
       indeg[ni]++;
     }
   }
   for (int i = 0; i < n; i++) {
-    if (indeg[i] != 1) {
-      free(indeg);
-      free(vis);
+    if (indeg[i] != 1)
       return 0;
-    }
   }
 
   int cur = 0;
   for (int step = 0; step < n; step++) {
-    if (vis[cur]) {
-      free(indeg);
-      free(vis);
+    if (vis[cur])
       return 0;
-    }
     vis[cur] = 1;
     cur = next[cur];
   }
-  if (cur != 0) {
-    free(indeg);
-    free(vis);
+  if (cur != 0)
     return 0;
-  }
   for (int i = 0; i < n; i++) {
-    if (!vis[i]) {
-      free(indeg);
-      free(vis);
+    if (!vis[i])
       return 0;
-    }
   }
-  free(indeg);
-  free(vis);
   return 1;
 }
 
 static int gen_cycle_maze_next(int w, int h, unsigned int seed, bool wrap,
-                               int *next, char *err, int err_len) {
-  int n = w * h;
-  if (n <= 0 || n > 16384) {
-    set_err(err, err_len, "generator supports up to 16384 cells");
-    return 1;
-  }
+                               int *next, const Workspace *ws, char *err,
+                               int err_len) {
   if (!next) {
     set_err(err, err_len, "next buffer is required");
     return 2;
@@ -580,7 +640,7 @@ static int gen_cycle_maze_next(int w, int h, unsigned int seed, bool wrap,
   }
 
   init_block_cycles(we, he, next);
-  build_maze_splices(we / 2, he / 2, we, next, seed);
+  build_maze_splices(we / 2, he / 2, we, next, seed, ws);
 
   if (w & 1)
     stitch_odd_col(w, he, next);
@@ -593,7 +653,7 @@ static int gen_cycle_maze_next(int w, int h, unsigned int seed, bool wrap,
     }
   }
 
-  if (!verify_cycle(next, w, h, wrap)) {
+  if (!verify_cycle(next, w, h, wrap, ws)) {
     set_err(err, err_len, "maze cycle verification failed");
     return 5;
   }
@@ -603,27 +663,323 @@ static int gen_cycle_maze_next(int w, int h, unsigned int seed, bool wrap,
 }
 
 static int gen_cycle_maze(int w, int h, unsigned int seed, bool wrap,
-                          char *out_dirs, char *err, int err_len) {
-  int n = w * h;
-  int *next = (int *)malloc((size_t)n * sizeof(int));
-  if (!next) {
-    set_err(err, err_len, "out of memory");
-    return 2;
-  }
-  int rc = gen_cycle_maze_next(w, h, seed, wrap, next, err, err_len);
-  if (rc != 0) {
-    free(next);
+                          char *out_dirs, const Workspace *ws, char *err,
+                          int err_len) {
+  int rc = gen_cycle_maze_next(w, h, seed, wrap, ws->next, ws, err, err_len);
+  if (rc != 0)
     return rc;
+  return next_to_dirs(w, h, ws->next, wrap, out_dirs, err, err_len);
+}
+
+// ------------------------------------------------------------
+// Cycle scrambler
+// ------------------------------------------------------------
+
+// The tour is kept as an implicit treap (ordered by tour position, not by
+// value) with parent links. That gives O(log n) expected time for
+// "position of cell", "cell at position", split and merge, which is all
+// the scrambler needs. Nodes are numbered in initial tour order, so nodes
+// close in the tour are close in memory; priorities are a hash of
+// (node, seed) so they need no storage.
+//
+// Arrays come from the workspace: tl/tr/tp/tsz for links and sizes,
+// tnode/tcell for the labels, ints as a traversal stack.
+
+typedef struct Tour {
+  int *l, *r, *p, *sz;
+  int *node_of; // cell -> node
+  int *cell_of; // node -> cell
+  int *stack;
+  uint32_t seed;
+  int root;
+  int n;
+} Tour;
+
+static uint32_t mix_u32(uint32_t x) {
+  x ^= x >> 16;
+  x *= 0x7feb352dU;
+  x ^= x >> 15;
+  x *= 0x846ca68bU;
+  x ^= x >> 16;
+  return x;
+}
+
+static inline uint32_t tour_prio(const Tour *t, int x) {
+  return mix_u32((uint32_t)x ^ t->seed);
+}
+
+static inline int tour_size(const Tour *t, int x) {
+  return (x < 0) ? 0 : t->sz[x];
+}
+
+static inline void tour_pull(Tour *t, int x) {
+  t->sz[x] = 1 + tour_size(t, t->l[x]) + tour_size(t, t->r[x]);
+  if (t->l[x] >= 0)
+    t->p[t->l[x]] = x;
+  if (t->r[x] >= 0)
+    t->p[t->r[x]] = x;
+}
+
+// First k positions of `x` go to *a, the rest to *b.
+static void tour_split(Tour *t, int x, int k, int *a, int *b) {
+  if (x < 0) {
+    *a = -1;
+    *b = -1;
+    return;
   }
-  rc = next_to_dirs(w, h, next, wrap, out_dirs, err, err_len);
-  free(next);
-  return rc;
+  int ls = tour_size(t, t->l[x]);
+  if (k <= ls) {
+    tour_split(t, t->l[x], k, a, &t->l[x]);
+    tour_pull(t, x);
+    *b = x;
+  } else {
+    tour_split(t, t->r[x], k - ls - 1, &t->r[x], b);
+    tour_pull(t, x);
+    *a = x;
+  }
+}
+
+static int tour_merge(Tour *t, int a, int b) {
+  if (a < 0)
+    return b;
+  if (b < 0)
+    return a;
+  if (tour_prio(t, a) > tour_prio(t, b)) {
+    t->r[a] = tour_merge(t, t->r[a], b);
+    tour_pull(t, a);
+    return a;
+  }
+  t->l[b] = tour_merge(t, a, t->l[b]);
+  tour_pull(t, b);
+  return b;
+}
+
+// Builds the treap in O(n) from the successor array, in tour order from
+// cell 0.
+static void tour_build(Tour *t, const int *next) {
+  int top = 0;
+  int cell = 0;
+  for (int x = 0; x < t->n; x++) {
+    t->node_of[cell] = x;
+    t->cell_of[x] = cell;
+    cell = next[cell];
+
+    t->l[x] = -1;
+    t->r[x] = -1;
+    t->p[x] = -1;
+
+    // Cartesian tree by priority (max-heap) over the sequence.
+    int last = -1;
+    uint32_t px = tour_prio(t, x);
+    while (top > 0 && tour_prio(t, t->stack[top - 1]) < px)
+      last = t->stack[--top];
+    t->l[x] = last;
+    if (last >= 0)
+      t->p[last] = x;
+    if (top > 0) {
+      t->r[t->stack[top - 1]] = x;
+      t->p[x] = t->stack[top - 1];
+    }
+    t->stack[top++] = x;
+  }
+  t->root = t->stack[0];
+
+  // Sizes: children before parents via reverse preorder. The preorder is
+  // written into sz itself, then overwritten in place by the sizes.
+  int sp = 0;
+  int count = 0;
+  t->stack[sp++] = t->root;
+  while (sp > 0) {
+    int v = t->stack[--sp];
+    t->sz[count++] = v;
+    if (t->l[v] >= 0)
+      t->stack[sp++] = t->l[v];
+    if (t->r[v] >= 0)
+      t->stack[sp++] = t->r[v];
+  }
+  // Move the order out of sz (into stack) before sz is reused.
+  for (int k = 0; k < count; k++)
+    t->stack[k] = t->sz[k];
+  for (int k = 0; k < count; k++)
+    t->sz[k] = 1;
+  for (int k = count - 1; k > 0; k--) {
+    int v = t->stack[k];
+    t->sz[t->p[v]] += t->sz[v];
+  }
+}
+
+// Position of a cell in the tour.
+static int tour_pos(Tour *t, int cell) {
+  int x = t->node_of[cell];
+  int pos = tour_size(t, t->l[x]);
+  for (int v = x; t->p[v] >= 0; v = t->p[v]) {
+    int par = t->p[v];
+    if (t->r[par] == v)
+      pos += tour_size(t, t->l[par]) + 1;
+  }
+  return pos;
+}
+
+// Cell at position k of the tour.
+static int tour_at(Tour *t, int k) {
+  int x = t->root;
+  for (;;) {
+    int ls = tour_size(t, t->l[x]);
+    if (k < ls) {
+      x = t->l[x];
+    } else if (k == ls) {
+      return t->cell_of[x];
+    } else {
+      k -= ls + 1;
+      x = t->r[x];
+    }
+  }
+}
+
+// Reorders the tour from A B C D to B A D C, where the cuts are at
+// positions i1 < i2 < i3 (A = [0, i1), B = [i1, i2), C = [i2, i3), D = rest).
+static void tour_reorder(Tour *t, int i1, int i2, int i3) {
+  int a, b, c, d, rest;
+  tour_split(t, t->root, i1, &a, &rest);
+  tour_split(t, rest, i2 - i1, &b, &rest);
+  tour_split(t, rest, i3 - i2, &c, &d);
+  t->root = tour_merge(t, tour_merge(t, b, a), tour_merge(t, d, c));
+  t->p[t->root] = -1;
+}
+
+// Rotates the tour so position k becomes position 0.
+static void tour_rotate(Tour *t, int k) {
+  int a, b;
+  tour_split(t, t->root, k, &a, &b);
+  t->root = tour_merge(t, b, a);
+  t->p[t->root] = -1;
+}
+
+// Writes the tour back into the successor array (in-order walk).
+static void tour_to_next(Tour *t, int *next) {
+  int sp = 0;
+  int prev = -1;
+  int first = -1;
+  int x = t->root;
+  while (x >= 0 || sp > 0) {
+    while (x >= 0) {
+      t->stack[sp++] = x;
+      x = t->l[x];
+    }
+    x = t->stack[--sp];
+    int cell = t->cell_of[x];
+    if (prev >= 0)
+      next[prev] = cell;
+    else
+      first = cell;
+    prev = cell;
+    x = t->r[x];
+  }
+  next[prev] = first;
+}
+
+// Neighbor of cell i one step along (dx, dy), or -1 if it leaves the board.
+static int step_cell(int w, int h, int i, int dx, int dy, bool wrap) {
+  int x = i % w + dx;
+  int y = i / w + dy;
+  if (wrap) {
+    x = (x + w) % w;
+    y = (y + h) % h;
+  } else if (x < 0 || x >= w || y < 0 || y >= h) {
+    return -1;
+  }
+  return cell_idx(w, x, y);
+}
+
+static bool cells_adjacent(int w, int h, int u, int v, bool wrap) {
+  IVec2 a = {u % w, u / w};
+  IVec2 b = {v % w, v / w};
+  return wrap ? is_adjacent_wrap(a, b, w, h) : is_adjacent_nonwrap(a, b);
+}
+
+// Position of x relative to position `base` (base maps to 0).
+static int tour_rel(Tour *t, int x, int base) {
+  int r = tour_pos(t, x) - base;
+  return (r < 0) ? r + t->n : r;
+}
+
+// Relative tour positions of the 5x5 cells around a (offsets -2..2),
+// looked up lazily; -1 marks cells off the board.
+typedef struct Around {
+  int cell[25];
+  int rel[25];
+} Around;
+
+static void around_init(Around *ar, int w, int h, int a, bool wrap) {
+  for (int k = 0; k < 25; k++) {
+    ar->cell[k] = step_cell(w, h, a, k % 5 - 2, k / 5 - 2, wrap);
+    ar->rel[k] = -2;
+  }
+}
+
+static int around_rel(Around *ar, Tour *t, int k, int base) {
+  if (ar->rel[k] == -2)
+    ar->rel[k] = (ar->cell[k] < 0) ? -1 : tour_rel(t, ar->cell[k], base);
+  return ar->rel[k];
+}
+
+// Checks whether the square sides {k1-k2, k3-k4} (indices into `ar`) rejoin
+// the two pieces left by a split at relative position k (pieces [0, k] and
+// [k + 1, n - 1]). On success stores the relative positions of the two
+// edges' first cells, lower one first.
+static bool find_join(Around *ar, Tour *t, int w, int h, bool wrap, int base,
+                      int k, int k1, int k2, int k3, int k4, int *out_lo1,
+                      int *out_lo2) {
+  int r1 = around_rel(ar, t, k1, base), r2 = around_rel(ar, t, k2, base);
+  if (r1 < 0 || r2 < 0 || abs(r1 - r2) != 1)
+    return false;
+  int r3 = around_rel(ar, t, k3, base), r4 = around_rel(ar, t, k4, base);
+  if (r3 < 0 || r4 < 0 || abs(r3 - r4) != 1)
+    return false;
+
+  // Orient each side along the tour: e->f and g->h.
+  int e = (r1 < r2) ? ar->cell[k1] : ar->cell[k2];
+  int f = (r1 < r2) ? ar->cell[k2] : ar->cell[k1];
+  int lo1 = (r1 < r2) ? r1 : r2;
+  int g = (r3 < r4) ? ar->cell[k3] : ar->cell[k4];
+  int hh = (r3 < r4) ? ar->cell[k4] : ar->cell[k3];
+  int lo2 = (r3 < r4) ? r3 : r4;
+  if (lo1 > lo2) {
+    int tmp = lo1;
+    lo1 = lo2;
+    lo2 = tmp;
+    tmp = e;
+    e = g;
+    g = tmp;
+    tmp = f;
+    f = hh;
+    hh = tmp;
+  }
+  // One edge in each piece (the edge k -> k + 1 spans both and is excluded).
+  if (lo1 + 1 > k || lo2 < k + 1)
+    return false;
+
+  // The sides must run antiparallel so e-h and f-g close the loop.
+  if (!cells_adjacent(w, h, e, hh, wrap) || !cells_adjacent(w, h, f, g, wrap))
+    return false;
+
+  *out_lo1 = lo1;
+  *out_lo2 = lo2;
+  return true;
 }
 
-// Generate into out_dirs (size w*h). Returns 0 on success.
-// Apply valid edge swaps to mutate an existing Hamiltonian cycle.
+// Mutate an existing Hamiltonian cycle with random pairs of square flips.
+//
+// Swapping the two tour edges of a unit square (a->b, d->c) for its other
+// two sides always splits the tour into two cycles, b..d and c..a. A nearby
+// square with one tour edge in each piece (e->f in b..d, g->h in c..a)
+// joins them again. With positions taken relative to b, the combined move
+// is a reorder of four position ranges in the tour treap, so an attempt
+// costs a bounded number of O(log n) operations and nothing is re-verified
+// per move; one full verify runs at the end.
 static int scramble_cycle(int w, int h, int *next, bool wrap,
-                          unsigned int seed, char *err, int err_len) {
+                          unsigned int seed, const Workspace *ws, char *err,
+                          int err_len) {
   int n = w * h;
   if (!next) {
     set_err(err, err_len, "next buffer is required");
@@ -635,101 +991,119 @@ static int scramble_cycle(int w, int h, int *next, bool wrap,
   int attempts = 0;
   int max_attempts = n * 50;
 
+  Tour t = {ws->tl, ws->tr, ws->tp, ws->tsz, ws->tnode, ws->tcell, ws->ints,
+            mix_u32(seed ^ 0x9E3779B9U), -1, n};
+  tour_build(&t, next);
+
   while (applied < target_swaps && attempts < max_attempts) {
     attempts++;
+
+    // First square: tour edge a->b and the two cells beside it.
     int a = rng_range(&rng, n);
-    int c = rng_range(&rng, n);
-    if (a == c)
+    int pb = tour_pos(&t, a) + 1;
+    if (pb == n)
+      pb = 0;
+    int b = tour_at(&t, pb);
+
+    bool horizontal = (a % w != b % w);
+    int side = (rng_next(&rng) & 1) ? 1 : -1;
+    int ox = horizontal ? 0 : side;
+    int oy = horizontal ? side : 0;
+
+    int c = step_cell(w, h, a, ox, oy, wrap);
+    int d = step_cell(w, h, b, ox, oy, wrap);
+    if (c < 0 || d < 0 || c == b || d == a || c == d)
       continue;
-    int b = next[a];
-    int d = next[c];
-    if (b == c || d == a || b == d)
-      continue;
-
-    IVec2 pa = {a % w, a / w};
-    IVec2 pb = {b % w, b / w};
-    IVec2 pc = {c % w, c / w};
-    IVec2 pd = {d % w, d / w};
 
-    bool adj_ad = wrap ? is_adjacent_wrap(pa, pd, w, h)
-                       : is_adjacent_nonwrap(pa, pd);
-    bool adj_cb = wrap ? is_adjacent_wrap(pc, pb, w, h)
-                       : is_adjacent_nonwrap(pc, pb);
-    if (!adj_ad || !adj_cb)
+    // Needs the tour edge d->c. Relative to b the pieces are then
+    // [0, k] (b..d) and [k + 1, n - 1] (c..a).
+    int k = tour_rel(&t, d, pb);
+    if (tour_rel(&t, c, pb) != k + 1)
       continue;
 
-    int old_b = b;
-    int old_d = d;
-    next[a] = old_d;
-    next[c] = old_b;
-    if (verify_cycle(next, w, h, wrap)) {
-      applied++;
-    } else {
-      next[a] = old_b;
-      next[c] = old_d;
+    // Second square: any unit square touching the first one (top-left
+    // within [-2, 1] x [-2, 1] of a), either side pair, scanned from a
+    // random starting candidate. Positions of the 5x5 cells around a are
+    // looked up at most once each.
+    Around ar;
+    around_init(&ar, w, h, a, wrap);
+    int sb = 12 + (horizontal ? (b == step_cell(w, h, a, 1, 0, wrap) ? 1 : -1)
+                              : (b == step_cell(w, h, a, 0, 1, wrap) ? 5 : -5));
+    int so = ox + 5 * oy;
+    ar.rel[12] = n - 1;      // a
+    ar.rel[sb] = 0;          // b
+    ar.rel[12 + so] = k + 1; // c
+    ar.rel[sb + so] = k;     // d
+    int lo1 = -1, lo2 = -1;
+    bool found = false;
+    int start = rng_range(&rng, 32);
+    for (int m = 0; m < 32 && !found; m++) {
+      int cand = (start + m) & 31;
+      int tl = (cand & 3) + ((cand >> 2) & 3) * 5; // in the 5x5 block
+      int tr = tl + 1, bl = tl + 5, br = tl + 6;
+      found = (cand & 16) ? find_join(&ar, &t, w, h, wrap, pb, k, tl, tr, bl,
+                                      br, &lo1, &lo2)
+                          : find_join(&ar, &t, w, h, wrap, pb, k, tl, bl, tr,
+                                      br, &lo1, &lo2);
     }
+    if (!found)
+      continue;
+
+    // b..e f..d c..g h..a  ->  f..d b..e h..a c..g
+    tour_rotate(&t, pb);
+    tour_reorder(&t, lo1 + 1, k + 1, lo2 + 1);
+    applied++;
   }
 
+  tour_to_next(&t, next);
+
   if (applied == 0) {
     set_err(err, err_len, "scramble failed to apply any swaps");
     return 2;
   }
+  if (!verify_cycle(next, w, h, wrap, ws)) {
+    set_err(err, err_len, "scrambled cycle verification failed");
+    return 3;
+  }
   set_err(err, err_len, "");
   return 0;
 }
 
+// Generate into out_dirs (size w*h, may be ws->dirs). Returns 0 on success.
 static int gen_cycle_by_type(int w, int h, unsigned int seed, bool wrap,
-                             CycleType type, char *out_dirs, char *err,
-                             int err_len) {
-  int n = w * h;
-  if (n <= 0 || n > 16384) {
-    set_err(err, err_len, "generator supports up to 16384 cells");
-    return 1;
-  }
-
+                             CycleType type, char *out_dirs,
+                             const Workspace *ws, char *err, int err_len) {
   if (type == CYCLE_SERPENTINE) {
-    static char dirs[16384];
-    if (!build_cycle_grid_base(w, h, dirs)) {
+    if (!build_cycle_grid_base(w, h, out_dirs)) {
       set_err(err, err_len, "serpentine cycle requires even w/h >= 4");
       return 2;
     }
-    int *next = (int *)malloc((size_t)n * sizeof(int));
-    if (!next) {
-      set_err(err, err_len, "out of memory");
-      return 3;
-    }
-    int rc = dirs_to_next(w, h, dirs, wrap, next, err, err_len);
-    if (rc == 0 && !verify_cycle(next, w, h, wrap)) {
+    int rc = dirs_to_next(w, h, out_dirs, wrap, ws->next, err, err_len);
+    if (rc == 0 && !verify_cycle(ws->next, w, h, wrap, ws)) {
       set_err(err, err_len, "serpentine cycle verification failed");
       rc = 4;
     }
     if (rc == 0)
-      rc = next_to_dirs(w, h, next, wrap, out_dirs, err, err_len);
-    free(next);
+      rc = next_to_dirs(w, h, ws->next, wrap, out_dirs, err, err_len);
     return rc;
   }
 
   if (type == CYCLE_SPIRAL) {
     unsigned int spiral_seed = seed ^ 0x5A5A5A5AU;
-    return gen_cycle_maze(w, h, spiral_seed, wrap, out_dirs, err, err_len);
+    return gen_cycle_maze(w, h, spiral_seed, wrap, out_dirs, ws, err, err_len);
   }
 
   if (type == CYCLE_MAZE) {
-    return gen_cycle_maze(w, h, seed, wrap, out_dirs, err, err_len);
+    return gen_cycle_maze(w, h, seed, wrap, out_dirs, ws, err, err_len);
   }
 
   if (type == CYCLE_SCRAMBLED) {
-    int *next = (int *)malloc((size_t)n * sizeof(int));
-    if (!next) {
-      set_err(err, err_len, "out of memory");
-      return 5;
-    }
-    int rc = gen_cycle_maze_next(w, h, seed, wrap, next, err, err_len);
+    int rc = gen_cycle_maze_next(w, h, seed, wrap, ws->next, ws, err, err_len);
     if (rc == 0)
-      rc = scramble_cycle(w, h, next, wrap, seed ^ 0xA5A5A5A5U, err, err_len);
+      rc = scramble_cycle(w, h, ws->next, wrap, seed ^ 0xA5A5A5A5U, ws, err,
+                          err_len);
     if (rc == 0)
-      rc = next_to_dirs(w, h, next, wrap, out_dirs, err, err_len);
-    free(next);
+      rc = next_to_dirs(w, h, ws->next, wrap, out_dirs, err, err_len);
     return rc;
   }
 
@@ -738,60 +1112,100 @@ static int gen_cycle_by_type(int w, int h, unsigned int seed, bool wrap,
 }
 
 static int gen_cycle_letters(int w, int h, unsigned int seed, CycleType type,
-                             bool wrap, char *out_dirs, char *err,
-                             int err_len) {
-  return gen_cycle_by_type(w, h, seed, wrap, type, out_dirs, err, err_len);
+                             bool wrap, char *out_dirs, const Workspace *ws,
+                             char *err, int err_len) {
+  return gen_cycle_by_type(w, h, seed, wrap, type, out_dirs, ws, err, err_len);
 }
 
 // Try non-wrapping first; if invalid, retry with wrapping and return that.
 static int gen_cycle_letters_with_fallback(int w, int h, unsigned int seed,
                                            CycleType type, bool *out_wrap,
-                                           char *out_dirs, char *err,
-                                           int err_len) {
+                                           char *out_dirs, const Workspace *ws,
+                                           char *err, int err_len) {
   if (out_wrap)
     *out_wrap = false;
-  int rc = gen_cycle_letters(w, h, seed, type, false, out_dirs, err, err_len);
+  int rc =
+      gen_cycle_letters(w, h, seed, type, false, out_dirs, ws, err, err_len);
   if (rc == 0)
     return 0;
-  rc = gen_cycle_letters(w, h, seed, type, true, out_dirs, err, err_len);
+  rc = gen_cycle_letters(w, h, seed, type, true, out_dirs, ws, err, err_len);
   if (rc == 0 && out_wrap)
     *out_wrap = true;
   return rc;
 }
 
-int snakebot_generate_cycle(int w, int h, char *out, int out_len, char *err,
-                            int err_len) {
-  if (w <= 0 || h <= 0) {
-    set_err(err, err_len, "w and h must be positive");
+long long snakebot_workspace_size(int w, int h) {
+  int n = cell_count(w, h);
+  if (n < 0)
+    return -1;
+  return ws_size_for(n);
+}
+
+static int generate_cycle_impl(int w, int h, char *out, int out_len,
+                               void *workspace, long long workspace_len,
+                               char *err, int err_len) {
+  const int n = cell_count(w, h);
+  if (n < 0) {
+    set_err(err, err_len, "w and h must be positive (and w*h fit in int)");
     return 1;
   }
   if (!out || out_len <= 0) {
     set_err(err, err_len, "out buffer is required");
     return 2;
   }
-
-  const int need = w * h + 1;
-  if (out_len < need) {
+  if (out_len - 1 < n) {
     set_err(err, err_len, "out_len must be >= w*h + 1");
     return 3;
   }
 
-  int rc = gen_cycle_letters_with_fallback(w, h, 0U, CYCLE_MAZE, NULL, out, err,
-                                           err_len);
+  Workspace ws;
+  if (ws_bind(n, workspace, workspace_len, &ws, err, err_len) != 0)
+    return 5;
+
+  int rc = gen_cycle_letters_with_fallback(w, h, 0U, CYCLE_MAZE, NULL, out,
+                                           &ws, err, err_len);
   if (rc != 0)
     return 4;
 
-  out[w * h] = '\0';
+  out[n] = '\0';
   set_err(err, err_len, "");
   return 0;
 }
 
+int snakebot_generate_cycle(int w, int h, char *out, int out_len, char *err,
+                            int err_len) {
+  const int n = cell_count(w, h);
+  if (n < 0) {
+    set_err(err, err_len, "w and h must be positive (and w*h fit in int)");
+    return 1;
+  }
+  void *ws = call_ws_alloc(n, err, err_len);
+  if (!ws)
+    return 5;
+  int rc = generate_cycle_impl(w, h, out, out_len, ws, ws_size_for(n), err,
+                               err_len);
+  free(ws);
+  return rc;
+}
+
+int snakebot_generate_cycle_ws(int w, int h, char *out, int out_len,
+                               void *workspace, long long workspace_len,
+                               char *err, int err_len) {
+  return generate_cycle_impl(w, h, out, out_len, workspace, workspace_len,
+                             err, err_len);
+}
+
 // ------------------------------------------------------------
 // Cycle validator
 // ------------------------------------------------------------
 
+static int walk_cycle_letters(int w, int h, const char *norm, bool wrap,
+                              const Workspace *ws, char *err, int err_len);
+
+// Uses ws->dirs (normalized letters) and ws->bytes (visited).
 static int validate_cycle_with_wrap(int w, int h, const char *cycle, bool wrap,
-                                    char *err, int err_len) {
+                                    const Workspace *ws, char *err,
+                                    int err_len) {
   if (w <= 0 || h <= 0) {
     set_err(err, err_len, "w and h must be positive");
     return 1;
@@ -801,37 +1215,21 @@ static int validate_cycle_with_wrap(int w, int h, const char *cycle, bool wrap,
     return 2;
   }
 
-  const int n = w * h;
-  // Parse normalized letters.
-  // Use a stack VLA for small boards; otherwise fall back to static cap.
-  // (This is fine for typical Snake sizes.)
-  if (n > 1000000) {
-    set_err(err, err_len, "grid too large to validate");
-    return 3;
-  }
-  char dirs[/*n*/ 1];
-  // Can't do VLA in MSVC reliably; use a fixed max instead.
-  // We'll validate typical sizes (<= 1024*1024); for larger, bail.
-  (void)dirs;
-
-  // Allocate a fixed buffer on heap? We promised no heap.
-  // So we validate using a rolling read: parse into a local static buffer
-  // with a conservative cap.
-  if (n > 16384) {
-    set_err(err, err_len,
-            "validation supports up to 16384 cells (e.g., 128x128). Reduce "
-            "board size.");
-    return 4;
-  }
-
-  static char norm[16384];
+  char *norm = ws->dirs;
   int pr = parse_cycle_letters(w, h, cycle, norm, err, err_len);
   if (pr != 0)
     return 5;
+  return walk_cycle_letters(w, h, norm, wrap, ws, err, err_len);
+}
 
+// Follows exactly w*h normalized letters from (0,0) and checks they form one
+// cycle. Uses ws->bytes (visited).
+static int walk_cycle_letters(int w, int h, const char *norm, bool wrap,
+                              const Workspace *ws, char *err, int err_len) {
+  const int n = w * h;
   // Visit by following directions starting at (0,0).
   // Mark visited cells.
-  static unsigned char seen[16384];
+  unsigned char *seen = ws->bytes;
   memset(seen, 0, (size_t)n);
 
   int x = 0, y = 0;
@@ -876,39 +1274,109 @@ static int validate_cycle_with_wrap(int w, int h, const char *cycle, bool wrap,
   return 0;
 }
 
+static int validate_cycle_impl(int w, int h, const char *cycle,
+                               void *workspace, long long workspace_len,
+                               char *err, int err_len) {
+  const int n = cell_count(w, h);
+  if (n < 0) {
+    set_err(err, err_len, "w and h must be positive (and w*h fit in int)");
+    return 1;
+  }
+  Workspace ws;
+  if (ws_bind(n, workspace, workspace_len, &ws, err, err_len) != 0)
+    return 4;
+  bool wrap = ((w & 1) && (h & 1));
+  return validate_cycle_with_wrap(w, h, cycle, wrap, &ws, err, err_len);
+}
+
 int snakebot_validate_cycle(int w, int h, const char *cycle, char *err,
                             int err_len) {
-  bool wrap = ((w & 1) && (h & 1));
-  return validate_cycle_with_wrap(w, h, cycle, wrap, err, err_len);
+  const int n = cell_count(w, h);
+  if (n < 0) {
+    set_err(err, err_len, "w and h must be positive (and w*h fit in int)");
+    return 1;
+  }
+  void *ws = call_ws_alloc(n, err, err_len);
+  if (!ws)
+    return 4;
+  int rc = validate_cycle_impl(w, h, cycle, ws, ws_size_for(n), err, err_len);
+  free(ws);
+  return rc;
+}
+
+int snakebot_validate_cycle_ws(int w, int h, const char *cycle,
+                               void *workspace, long long workspace_len,
+                               char *err, int err_len) {
+  return validate_cycle_impl(w, h, cycle, workspace, workspace_len, err,
+                             err_len);
 }
 
 // ------------------------------------------------------------
-// .cycle container builder/validator
+// .cycle writer
 // ------------------------------------------------------------
 
-static const char *skip_ws_lines(const char *p) {
-  while (p && (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\n'))
-    p++;
-  return p;
-}
+// Every container is produced by emit_cycle_file, which pushes the header and
+// rows through a fixed chunk to a write callback. The in-memory builders just
+// use a callback that appends to the caller's buffer. The chunk lives on the
+// stack, so streaming needs no memory beyond the workspace.
+#define EMIT_CHUNK 16384
+// Generous bound on the text header.
+#define CYCLE_FILE_HEADER_MAX 256
 
-static int parse_int_kv(const char *key, const char *line, int *out) {
-  size_t klen = strlen(key);
-  if (strncmp(line, key, klen) != 0)
-    return 0;
-  if (line[klen] != '=')
+static const char k_dir_letters[4] = {'U', 'D', 'L', 'R'};
+
+static int dir_letter_code(char c) {
+  switch (c) {
+  case 'U':
     return 0;
-  const char *v = line + klen + 1;
-  while (*v == ' ' || *v == '\t')
-    v++;
-  *out = atoi(v);
-  return 1;
+  case 'D':
+    return 1;
+  case 'L':
+    return 2;
+  default:
+    return 3;
+  }
 }
 
-int snakebot_build_cycle_file_ex(int w, int h, int window_w, int window_h,
-                                 unsigned int seed, const char *cycle_type,
-                                 char *out, int out_len, char *err,
-                                 int err_len) {
+typedef struct Emitter {
+  snakebot_write_fn write;
+  void *user;
+  int used;
+  bool failed;
+  char buf[EMIT_CHUNK];
+} Emitter;
+
+static void emit_flush(Emitter *e) {
+  if (e->used > 0 && !e->failed && e->write(e->user, e->buf, e->used) != 0)
+    e->failed = true;
+  e->used = 0;
+}
+
+static void emit_byte(Emitter *e, char c) {
+  e->buf[e->used++] = c;
+  if (e->used == EMIT_CHUNK)
+    emit_flush(e);
+}
+
+static void emit_bytes(Emitter *e, const char *data, size_t len) {
+  while (len > 0 && !e->failed) {
+    size_t take = (size_t)(EMIT_CHUNK - e->used);
+    if (take > len)
+      take = len;
+    memcpy(e->buf + e->used, data, take);
+    e->used += (int)take;
+    data += take;
+    len -= take;
+    if (e->used == EMIT_CHUNK)
+      emit_flush(e);
+  }
+}
+
+static int emit_cycle_file(int w, int h, int window_w, int window_h,
+                           unsigned int seed, const char *cycle_type,
+                           int format, snakebot_write_fn write, void *user,
+                           void *workspace, long long workspace_len, char *err,
+                           int err_len) {
   if (w <= 0 || h <= 0) {
     set_err(err, err_len, "w and h must be positive");
     return 1;
@@ -917,6 +1385,10 @@ int snakebot_build_cycle_file_ex(int w, int h, int window_w, int window_h,
     set_err(err, err_len, "w and h must be >= 2");
     return 2;
   }
+  if (format != SNAKEBOT_FORMAT_TEXT && format != SNAKEBOT_FORMAT_BINARY) {
+    set_err(err, err_len, "format must be SNAKEBOT_FORMAT_TEXT or _BINARY");
+    return 3;
+  }
   if (window_w <= 0 || window_h <= 0) {
     set_err(err, err_len, "window_w and window_h must be positive");
     return 4;
@@ -925,70 +1397,229 @@ int snakebot_build_cycle_file_ex(int w, int h, int window_w, int window_h,
     set_err(err, err_len, "window size must be divisible by grid size");
     return 6;
   }
-  if (!out || out_len <= 0) {
-    set_err(err, err_len, "out buffer is required");
+  if (!write) {
+    set_err(err, err_len, "write callback is required");
     return 7;
   }
 
-  const int n = w * h;
-  if (n > 16384) {
-    set_err(err, err_len,
-            "supports up to 16384 cells (e.g., 128x128). Reduce board size.");
+  const int n = cell_count(w, h);
+  if (n < 0) {
+    set_err(err, err_len, "w*h is too large");
     return 8;
   }
 
-  static char dirs[16384];
+  Workspace ws;
+  if (ws_bind(n, workspace, workspace_len, &ws, err, err_len) != 0)
+    return 8;
+
+  char *dirs = ws.dirs;
   bool wrap_used = false;
   CycleType type = CYCLE_MAZE;
   if (parse_cycle_type(cycle_type, &type, err, err_len) != 0)
     return 9;
   int grc = gen_cycle_letters_with_fallback(w, h, seed, type, &wrap_used, dirs,
-                                            err, err_len);
+                                            &ws, err, err_len);
   if (grc != 0)
     return 9;
 
-  // Compose header + metadata.
-  int off = 0;
-  int wrote = snprintf(out + off, (size_t)out_len - (size_t)off,
-                       "SNAKECYCLE 1\n"
-                       "width=%d\n"
-                       "height=%d\n"
-                       "window_w=%d\n"
-                       "window_h=%d\n"
-                       "seed=%u\n"
-                       "cycle_type=%s\n"
-                       "wrap=%d\n"
-                       "DATA\n",
-                       w, h, window_w, window_h, seed,
-                       cycle_type ? cycle_type : "maze",
-                       wrap_used ? 1 : 0);
-  if (wrote < 0) {
-    set_err(err, err_len, "snprintf failed");
-    return 5;
+  const char *type_name = cycle_type ? cycle_type : "maze";
+  Emitter emitter;
+  Emitter *e = &emitter;
+  e->write = write;
+  e->user = user;
+  e->used = 0;
+  e->failed = false;
+
+  if (format == SNAKEBOT_FORMAT_TEXT) {
+    char header[CYCLE_FILE_HEADER_MAX];
+    int wrote = snprintf(header, sizeof(header),
+                         "SNAKECYCLE 1\n"
+                         "width=%d\n"
+                         "height=%d\n"
+                         "window_w=%d\n"
+                         "window_h=%d\n"
+                         "seed=%u\n"
+                         "cycle_type=%s\n"
+                         "wrap=%d\n"
+                         "DATA\n",
+                         w, h, window_w, window_h, seed, type_name,
+                         wrap_used ? 1 : 0);
+    if (wrote < 0 || wrote >= (int)sizeof(header)) {
+      set_err(err, err_len, "header does not fit");
+      return 5;
+    }
+    emit_bytes(e, header, (size_t)wrote);
+    // Write directions as a neat grid for human-readability.
+    for (int y = 0; y < h && !e->failed; y++) {
+      emit_bytes(e, dirs + (size_t)y * (size_t)w, (size_t)w);
+      emit_byte(e, '\n');
+    }
+  } else {
+    CycleFileMeta meta = {
+        .width = w,
+        .height = h,
+        .window_w = window_w,
+        .window_h = window_h,
+        .seed = seed,
+        .wrap = wrap_used ? 1 : 0,
+    };
+    snprintf(meta.cycle_type, sizeof(meta.cycle_type), "%s", type_name);
+    uint8_t header[CYCLE_BIN_HEADER_SIZE];
+    CycleFile_WriteBinHeader(header, &meta);
+    emit_bytes(e, (const char *)header, sizeof(header));
+    // Four cells per byte, see cycle_file.h.
+    for (int i = 0; i < n && !e->failed; i += 4) {
+      int packed = 0;
+      for (int k = 0; k < 4 && i + k < n; k++)
+        packed |= dir_letter_code(dirs[i + k]) << (k * 2);
+      emit_byte(e, (char)packed);
+    }
   }
-  off += wrote;
-  if (off >= out_len) {
-    set_err(err, err_len, "out_len too small for header");
-    return 6;
+  emit_flush(e);
+  if (e->failed) {
+    set_err(err, err_len, "write callback failed");
+    return 11;
   }
 
-  // Write directions as a neat grid for human-readability.
-  for (int y = 0; y < h; y++) {
-    for (int x = 0; x < w; x++) {
-      if (off + 2 >= out_len) { // room for char + newline + null
-        set_err(err, err_len, "out_len too small for cycle data");
-        return 7;
-      }
-      out[off++] = dirs[y * w + x];
-    }
-    out[off++] = '\n';
+  set_err(err, err_len, "");
+  return 0;
+}
+
+int snakebot_write_cycle_file_ws(int w, int h, int window_w, int window_h,
+                                 unsigned int seed, const char *cycle_type,
+                                 int format, snakebot_write_fn write,
+                                 void *user, void *workspace,
+                                 long long workspace_len, char *err,
+                                 int err_len) {
+  return emit_cycle_file(w, h, window_w, window_h, seed, cycle_type, format,
+                         write, user, workspace, workspace_len, err, err_len);
+}
+
+static int file_sink_write(void *user, const void *data, int len) {
+  return fwrite(data, 1, (size_t)len, (FILE *)user) == (size_t)len ? 0 : 1;
+}
+
+static int save_cycle_file_impl(const char *path, int w, int h, int window_w,
+                                int window_h, unsigned int seed,
+                                const char *cycle_type, int format,
+                                void *workspace, long long workspace_len,
+                                char *err, int err_len) {
+  if (!path || !*path) {
+    set_err(err, err_len, "path is required");
+    return 1;
+  }
+  FILE *f = fopen(path, "wb");
+  if (!f) {
+    set_err(err, err_len, "failed to open output file");
+    return 12;
   }
-  out[off] = '\0';
+  int rc = emit_cycle_file(w, h, window_w, window_h, seed, cycle_type, format,
+                           file_sink_write, f, workspace, workspace_len, err,
+                           err_len);
+  if (fclose(f) != 0 && rc == 0) {
+    set_err(err, err_len, "failed to write output file");
+    rc = 12;
+  }
+  // Never leave a truncated .cycle behind.
+  if (rc != 0)
+    remove(path);
+  return rc;
+}
 
-  set_err(err, err_len, "");
+int snakebot_save_cycle_file(const char *path, int w, int h, int window_w,
+                             int window_h, unsigned int seed,
+                             const char *cycle_type, int format, char *err,
+                             int err_len) {
+  const int n = cell_count(w, h);
+  if (n < 0) {
+    set_err(err, err_len, "w and h must be positive (and w*h fit in int)");
+    return 1;
+  }
+  void *ws = call_ws_alloc(n, err, err_len);
+  if (!ws)
+    return 8;
+  int rc = save_cycle_file_impl(path, w, h, window_w, window_h, seed,
+                                cycle_type, format, ws, ws_size_for(n), err,
+                                err_len);
+  free(ws);
+  return rc;
+}
+
+int snakebot_save_cycle_file_ws(const char *path, int w, int h, int window_w,
+                                int window_h, unsigned int seed,
+                                const char *cycle_type, int format,
+                                void *workspace, long long workspace_len,
+                                char *err, int err_len) {
+  return save_cycle_file_impl(path, w, h, window_w, window_h, seed, cycle_type,
+                              format, workspace, workspace_len, err, err_len);
+}
+
+// In-memory sink for the buffer-returning builders.
+typedef struct BufSink {
+  char *out;
+  long long len;
+  long long off;
+} BufSink;
+
+static int buf_sink_write(void *user, const void *data, int len) {
+  BufSink *s = (BufSink *)user;
+  if (len > s->len - s->off)
+    return 1;
+  memcpy(s->out + s->off, data, (size_t)len);
+  s->off += len;
+  return 0;
+}
+
+static int build_cycle_file_impl(int w, int h, int window_w, int window_h,
+                                 unsigned int seed, const char *cycle_type,
+                                 char *out, int out_len, void *workspace,
+                                 long long workspace_len, char *err,
+                                 int err_len) {
+  if (!out || out_len <= 0) {
+    set_err(err, err_len, "out buffer is required");
+    return 7;
+  }
+  // Keep the last byte for the terminator.
+  BufSink sink = {out, (long long)out_len - 1, 0};
+  int rc = emit_cycle_file(w, h, window_w, window_h, seed, cycle_type,
+                           SNAKEBOT_FORMAT_TEXT, buf_sink_write, &sink,
+                           workspace, workspace_len, err, err_len);
+  if (rc == 11)
+    set_err(err, err_len, "out_len too small for cycle data");
+  if (rc != 0)
+    return rc;
+  out[sink.off] = '\0';
   return 0;
 }
 
+int snakebot_build_cycle_file_ex(int w, int h, int window_w, int window_h,
+                                 unsigned int seed, const char *cycle_type,
+                                 char *out, int out_len, char *err,
+                                 int err_len) {
+  const int n = cell_count(w, h);
+  if (n < 0) {
+    set_err(err, err_len, "w and h must be positive (and w*h fit in int)");
+    return 1;
+  }
+  void *ws = call_ws_alloc(n, err, err_len);
+  if (!ws)
+    return 8;
+  int rc = build_cycle_file_impl(w, h, window_w, window_h, seed, cycle_type,
+                                 out, out_len, ws, ws_size_for(n), err,
+                                 err_len);
+  free(ws);
+  return rc;
+}
+
+int snakebot_build_cycle_file_ex_ws(int w, int h, int window_w, int window_h,
+                                    unsigned int seed, const char *cycle_type,
+                                    char *out, int out_len, void *workspace,
+                                    long long workspace_len, char *err,
+                                    int err_len) {
+  return build_cycle_file_impl(w, h, window_w, window_h, seed, cycle_type, out,
+                               out_len, workspace, workspace_len, err, err_len);
+}
+
 int snakebot_build_cycle_file(int w, int h, int window_w, int window_h,
                               unsigned int seed, char *out, int out_len,
                               char *err, int err_len) {
@@ -996,105 +1627,390 @@ int snakebot_build_cycle_file(int w, int h, int window_w, int window_h,
                                       out, out_len, err, err_len);
 }
 
-int snakebot_validate_cycle_file(const char *cycle_file_text, int *out_w,
-                                 int *out_h, char *err, int err_len) {
-  if (!cycle_file_text) {
-    set_err(err, err_len, "cycle_file_text must be non-null");
-    return 1;
+// ------------------------------------------------------------
+// Batch generation
+// ------------------------------------------------------------
+
+// Upper bound on workers; their handles live on the caller's stack.
+#define BATCH_MAX_WORKERS 64
+
+typedef struct BatchJob {
+  int w, h, window_w, window_h;
+  unsigned int seed_first;
+  int count;
+  const char *cycle_type;
+  char *out;
+  int slot_len;
+  long long out_stride;
+  int *out_rc;
+  long next; // next unclaimed index; only touched through batch_claim
+} BatchJob;
+
+typedef struct BatchWorker {
+  BatchJob *job;
+  void *workspace;
+  long long workspace_len;
+} BatchWorker;
+
+static long batch_claim(BatchJob *job) {
+#if defined(_WIN32)
+  return InterlockedIncrement((volatile LONG *)&job->next) - 1;
+#else
+  return __atomic_fetch_add(&job->next, 1, __ATOMIC_RELAXED);
+#endif
+}
+
+// Workers pull seeds until the range is exhausted. Each slot is private to
+// its seed, so a failure just leaves the message in that slot.
+static void batch_run(BatchWorker *wk) {
+  BatchJob *job = wk->job;
+  for (;;) {
+    long i = batch_claim(job);
+    if (i >= job->count)
+      break;
+    char *slot = job->out + (long long)i * job->out_stride;
+    char msg[128];
+    int rc = build_cycle_file_impl(
+        job->w, job->h, job->window_w, job->window_h,
+        job->seed_first + (unsigned int)i, job->cycle_type, slot,
+        job->slot_len, wk->workspace, wk->workspace_len, msg, (int)sizeof msg);
+    if (rc != 0)
+      set_err(slot, job->slot_len, msg);
+    job->out_rc[i] = rc;
   }
+}
 
-  const char *p = skip_ws_lines(cycle_file_text);
-  const char *line_end = strpbrk(p, "\r\n");
-  if (!line_end) {
-    set_err(err, err_len, "missing header line");
+#if defined(_WIN32)
+typedef HANDLE BatchThread;
+
+static DWORD WINAPI batch_thread_main(LPVOID arg) {
+  batch_run((BatchWorker *)arg);
+  return 0;
+}
+
+static bool batch_thread_start(BatchThread *t, BatchWorker *wk) {
+  *t = CreateThread(NULL, 0, batch_thread_main, wk, 0, NULL);
+  return *t != NULL;
+}
+
+static void batch_thread_join(BatchThread t) {
+  WaitForSingleObject(t, INFINITE);
+  CloseHandle(t);
+}
+
+static int cpu_count(void) {
+  SYSTEM_INFO si;
+  GetSystemInfo(&si);
+  return (int)si.dwNumberOfProcessors;
+}
+#else
+typedef pthread_t BatchThread;
+
+static void *batch_thread_main(void *arg) {
+  batch_run((BatchWorker *)arg);
+  return NULL;
+}
+
+static bool batch_thread_start(BatchThread *t, BatchWorker *wk) {
+  return pthread_create(t, NULL, batch_thread_main, wk) == 0;
+}
+
+static void batch_thread_join(BatchThread t) { pthread_join(t, NULL); }
+
+static int cpu_count(void) {
+  long c = sysconf(_SC_NPROCESSORS_ONLN);
+  return (c > 0 && c < INT_MAX) ? (int)c : 1;
+}
+#endif
+
+long long snakebot_cycle_file_max_len(int w, int h) {
+  const int n = cell_count(w, h);
+  if (n < 0)
+    return -1;
+  return (long long)n + h + CYCLE_FILE_HEADER_MAX;
+}
+
+int snakebot_build_cycle_files_batch(int w, int h, int window_w, int window_h,
+                                     unsigned int seed_first, int count,
+                                     const char *cycle_type, int threads,
+                                     char *out, long long out_stride,
+                                     int *out_rc, void *workspace,
+                                     long long workspace_len, char *err,
+                                     int err_len) {
+  const int n = cell_count(w, h);
+  if (n < 0) {
+    set_err(err, err_len, "w and h must be positive (and w*h fit in int)");
+    return 1;
+  }
+  if (count <= 0) {
+    set_err(err, err_len, "count must be positive");
     return 2;
   }
-  size_t hl = (size_t)(line_end - p);
-  if (hl != strlen("SNAKECYCLE 1") || strncmp(p, "SNAKECYCLE 1", hl) != 0) {
-    set_err(err, err_len, "invalid header (expected 'SNAKECYCLE 1')");
+  if (!out || !out_rc || out_stride <= 0) {
+    set_err(err, err_len, "out, out_stride and out_rc are required");
     return 3;
   }
+  CycleType type;
+  if (parse_cycle_type(cycle_type, &type, err, err_len) != 0)
+    return 4;
 
-  int w = -1, h = -1;
-  int window_w = -1, window_h = -1;
-  int wrap = -1;
-  int have_data = 0;
-  const char *data_start = NULL;
-
-  p = line_end;
-  while (*p == '\r' || *p == '\n')
-    p++;
-
-  // Parse metadata lines until DATA.
-  while (*p) {
-    const char *e = strpbrk(p, "\r\n");
-    size_t len = e ? (size_t)(e - p) : strlen(p);
-
-    // Copy line into a small buffer for parsing.
-    char line[256];
-    if (len >= sizeof(line))
-      len = sizeof(line) - 1;
-    memcpy(line, p, len);
-    line[len] = '\0';
-
-    // Trim leading spaces.
-    char *s = line;
-    while (*s == ' ' || *s == '\t')
-      s++;
-
-    if (*s == '\0' || *s == '#') {
-      // skip
-    } else if (strcmp(s, "DATA") == 0) {
-      have_data = 1;
-      data_start = e ? (e + 1) : (p + len);
-      break;
-    } else {
-      (void)parse_int_kv("width", s, &w);
-      (void)parse_int_kv("height", s, &h);
-      (void)parse_int_kv("window_w", s, &window_w);
-      (void)parse_int_kv("window_h", s, &window_h);
-      (void)parse_int_kv("wrap", s, &wrap);
+  // Each worker owns one snakebot_workspace_size slice of the workspace.
+  const long long slice = ws_size_for(n);
+  if (!workspace || workspace_len < slice) {
+    set_err(err, err_len,
+            "workspace too small (see snakebot_workspace_size)");
+    return 5;
+  }
+  long long fit = workspace_len / slice;
+  int workers = threads > 0 ? threads : cpu_count();
+  if (workers > count)
+    workers = count;
+  if (workers > BATCH_MAX_WORKERS)
+    workers = BATCH_MAX_WORKERS;
+  if (workers > fit)
+    workers = (int)fit;
+
+  BatchJob job = {
+      .w = w,
+      .h = h,
+      .window_w = window_w,
+      .window_h = window_h,
+      .seed_first = seed_first,
+      .count = count,
+      .cycle_type = cycle_type,
+      .out = out,
+      .slot_len = out_stride > INT_MAX ? INT_MAX : (int)out_stride,
+      .out_stride = out_stride,
+      .out_rc = out_rc,
+      .next = 0,
+  };
+  BatchWorker wk[BATCH_MAX_WORKERS];
+  BatchThread th[BATCH_MAX_WORKERS];
+  bool started[BATCH_MAX_WORKERS] = {false};
+  for (int t = 0; t < workers; t++) {
+    wk[t].job = &job;
+    wk[t].workspace = (unsigned char *)workspace + (long long)t * slice;
+    wk[t].workspace_len = slice;
+  }
+  // The calling thread is worker 0; a worker that fails to start only
+  // leaves more seeds for the others.
+  for (int t = 1; t < workers; t++)
+    started[t] = batch_thread_start(&th[t], &wk[t]);
+  batch_run(&wk[0]);
+  for (int t = 1; t < workers; t++) {
+    if (started[t])
+      batch_thread_join(th[t]);
+  }
+
+  int failed = 0;
+  int first_failed = -1;
+  for (int i = 0; i < count; i++) {
+    if (out_rc[i] != 0) {
+      failed++;
+      if (first_failed < 0)
+        first_failed = i;
     }
+  }
+  if (failed > 0) {
+    if (err && err_len > 0)
+      snprintf(err, (size_t)err_len, "%d of %d cycles failed (seed %u: %s)",
+               failed, count, seed_first + (unsigned int)first_failed,
+               out + (long long)first_failed * out_stride);
+    return 6;
+  }
+  set_err(err, err_len, "");
+  return 0;
+}
 
-    if (!e)
-      break;
-    p = e;
-    while (*p == '\r' || *p == '\n')
-      p++;
+// ------------------------------------------------------------
+// Binary container (SNAKECYCLE 2, see cycle_file.h)
+// ------------------------------------------------------------
+
+long long snakebot_cycle_file_bin_size(int w, int h) {
+  return CycleFile_BinSize(w, h);
+}
+
+static int build_cycle_file_bin_impl(int w, int h, int window_w, int window_h,
+                                     unsigned int seed, const char *cycle_type,
+                                     void *out, long long out_len,
+                                     void *workspace, long long workspace_len,
+                                     char *err, int err_len) {
+  const long long size = CycleFile_BinSize(w, h);
+  if (size < 0) {
+    set_err(err, err_len, "w*h is too large");
+    return 8;
+  }
+  if (!out || out_len < size) {
+    set_err(err, err_len, "out_len must be >= snakebot_cycle_file_bin_size");
+    return 7;
   }
+  BufSink sink = {(char *)out, out_len, 0};
+  return emit_cycle_file(w, h, window_w, window_h, seed, cycle_type,
+                         SNAKEBOT_FORMAT_BINARY, buf_sink_write, &sink,
+                         workspace, workspace_len, err, err_len);
+}
 
-  if (!have_data || !data_start) {
-    set_err(err, err_len, "missing DATA section");
-    return 4;
+int snakebot_build_cycle_file_bin(int w, int h, int window_w, int window_h,
+                                  unsigned int seed, const char *cycle_type,
+                                  void *out, long long out_len, char *err,
+                                  int err_len) {
+  const int n = cell_count(w, h);
+  if (n < 0) {
+    set_err(err, err_len, "w and h must be positive (and w*h fit in int)");
+    return 1;
   }
-  if (w <= 0 || h <= 0) {
-    set_err(err, err_len, "missing/invalid width or height metadata");
-    return 5;
+  void *ws = call_ws_alloc(n, err, err_len);
+  if (!ws)
+    return 8;
+  int rc = build_cycle_file_bin_impl(w, h, window_w, window_h, seed,
+                                     cycle_type, out, out_len, ws,
+                                     ws_size_for(n), err, err_len);
+  free(ws);
+  return rc;
+}
+
+int snakebot_build_cycle_file_bin_ws(int w, int h, int window_w, int window_h,
+                                     unsigned int seed, const char *cycle_type,
+                                     void *out, long long out_len,
+                                     void *workspace, long long workspace_len,
+                                     char *err, int err_len) {
+  if (cell_count(w, h) < 0) {
+    set_err(err, err_len, "w and h must be positive (and w*h fit in int)");
+    return 1;
   }
-  if (window_w <= 0 || window_h <= 0) {
+  return build_cycle_file_bin_impl(w, h, window_w, window_h, seed, cycle_type,
+                                   out, out_len, workspace, workspace_len, err,
+                                   err_len);
+}
+
+// ------------------------------------------------------------
+// Container validation
+// ------------------------------------------------------------
+
+// Both formats are parsed by cycle_file.c, the same code the game loads
+// them with.
+static int validate_cycle_file_impl(const void *data, size_t len, int *out_w,
+                                    int *out_h, void *workspace,
+                                    long long workspace_len, char *err,
+                                    int err_len) {
+  CycleFileMeta meta;
+  size_t data_off = 0;
+  if (!CycleFile_ParseMeta(data, len, &meta, &data_off, err, err_len))
+    return 3;
+  if (meta.window_w <= 0 || meta.window_h <= 0) {
     set_err(err, err_len, "missing/invalid window size metadata");
     return 6;
   }
-  if ((window_w % w) != 0 || (window_h % h) != 0) {
+  if ((meta.window_w % meta.width) != 0 ||
+      (meta.window_h % meta.height) != 0) {
     set_err(err, err_len, "window size must be divisible by grid size");
     return 7;
   }
-  if (w * h > 16384) {
-    set_err(err, err_len, "validation supports up to 16384 cells");
+  const int n = meta.width * meta.height;
+  Workspace ws;
+  if (ws_bind(n, workspace, workspace_len, &ws, err, err_len) != 0)
     return 8;
-  }
 
   if (out_w)
-    *out_w = w;
+    *out_w = meta.width;
   if (out_h)
-    *out_h = h;
+    *out_h = meta.height;
+
+  // Decode to codes, then to the letters the walker expects, in place.
+  uint8_t *codes = (uint8_t *)ws.dirs;
+  if (!CycleFile_DecodeDirs(data, len, &meta, data_off, codes, err, err_len))
+    return 5;
+  for (int i = 0; i < n; i++)
+    ws.dirs[i] = k_dir_letters[codes[i]];
 
-  // Validate the cycle directions within the DATA section.
-  bool use_wrap = (wrap >= 0) ? (wrap != 0) : ((w & 1) && (h & 1));
-  int vrc = validate_cycle_with_wrap(w, h, data_start, use_wrap, err, err_len);
-  if (vrc != 0)
+  bool wrap = (meta.wrap >= 0) ? (meta.wrap != 0)
+                               : ((meta.width & 1) && (meta.height & 1));
+  if (walk_cycle_letters(meta.width, meta.height, ws.dirs, wrap, &ws, err,
+                         err_len) != 0)
     return 10;
 
   set_err(err, err_len, "");
   return 0;
 }
+
+// ParseMeta has already bounded the declared board by the input length, so
+// the per-call workspace can be sized from the metadata.
+static int validate_cycle_file_alloc(const void *data, size_t len, int *out_w,
+                                     int *out_h, char *err, int err_len) {
+  CycleFileMeta meta;
+  size_t data_off = 0;
+  if (!CycleFile_ParseMeta(data, len, &meta, &data_off, err, err_len))
+    return 3;
+  const int n = meta.width * meta.height;
+  void *ws = call_ws_alloc(n, err, err_len);
+  if (!ws)
+    return 8;
+  int rc = validate_cycle_file_impl(data, len, out_w, out_h, ws,
+                                    ws_size_for(n), err, err_len);
+  free(ws);
+  return rc;
+}
+
+int snakebot_validate_cycle_file(const char *cycle_file_text, int *out_w,
+                                 int *out_h, char *err, int err_len) {
+  if (!cycle_file_text) {
+    set_err(err, err_len, "cycle_file_text must be non-null");
+    return 1;
+  }
+  return validate_cycle_file_alloc(cycle_file_text, strlen(cycle_file_text),
+                                   out_w, out_h, err, err_len);
+}
+
+int snakebot_validate_cycle_file_ws(const char *cycle_file_text, int *out_w,
+                                    int *out_h, void *workspace,
+                                    long long workspace_len, char *err,
+                                    int err_len) {
+  if (!cycle_file_text) {
+    set_err(err, err_len, "cycle_file_text must be non-null");
+    return 1;
+  }
+  return validate_cycle_file_impl(cycle_file_text, strlen(cycle_file_text),
+                                  out_w, out_h, workspace, workspace_len, err,
+                                  err_len);
+}
+
+int snakebot_validate_cycle_file_bin(const void *data, long long len,
+                                     int *out_w, int *out_h, char *err,
+                                     int err_len) {
+  if (!data || len <= 0) {
+    set_err(err, err_len, "cycle file data must be non-null");
+    return 1;
+  }
+  return validate_cycle_file_alloc(data, (size_t)len, out_w, out_h, err,
+                                   err_len);
+}
+
+int snakebot_validate_cycle_file_bin_ws(const void *data, long long len,
+                                        int *out_w, int *out_h,
+                                        void *workspace,
+                                        long long workspace_len, char *err,
+                                        int err_len) {
+  if (!data || len <= 0) {
+    set_err(err, err_len, "cycle file data must be non-null");
+    return 1;
+  }
+  return validate_cycle_file_impl(data, (size_t)len, out_w, out_h, workspace,
+                                  workspace_len, err, err_len);
+}
+
+int snakebot_validate_cycle_file_path(const char *path, int *out_w, int *out_h,
+                                      char *err, int err_len) {
+  if (!path) {
+    set_err(err, err_len, "path must be non-null");
+    return 1;
+  }
+  CycleFileMap map;
+  if (!CycleFile_Map(&map, path)) {
+    set_err(err, err_len, "failed to open cycle file (or it is empty)");
+    return 2;
+  }
+  int rc = validate_cycle_file_alloc(map.data, map.size, out_w, out_h, err,
+                                     err_len);
+  CycleFile_Unmap(&map);
+  return rc;
+}
@@ -0,0 +1,290 @@
+#include "botlib.h"
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <pthread.h>
+#endif
+
+/*
+ * botlib_stress.c
+ * Reentrancy stress test for botlib (botlib_stress target, off by default).
+ *
+ * Builds a fixed set of jobs (mixed board sizes, cycle types and seeds)
+ * once on the main thread, then has N threads redo them for several rounds
+ * and compares every output byte for byte against the serial results. Each
+ * job exercises the plain (allocating) and *_ws entry points for text and
+ * binary files, plus generate/validate. Exit status 0 means no mismatches
+ * and no errors.
+ */
+
+#define STRESS_JOBS 64
+#define STRESS_THREADS 8
+#define STRESS_ROUNDS 20
+#define STRESS_ERR_LEN 256
+
+static const char *const k_types[] = {"maze", "spiral", "serpentine",
+                                      "scrambled"};
+
+typedef struct StressJob {
+  int w, h;
+  unsigned int seed;
+  const char *type;
+
+  // Serial reference outputs.
+  char *text;
+  unsigned char *bin;
+  long long bin_len;
+  char *cycle;
+} StressJob;
+
+typedef struct StressOut {
+  char *text;
+  char *text_ws;
+  unsigned char *bin;
+  unsigned char *bin_ws;
+  char *cycle;
+  void *ws;
+  long long ws_len;
+} StressOut;
+
+typedef struct StressWorker {
+  StressJob *jobs;
+  int first, step, rounds;
+  int mismatches;
+  int errors;
+} StressWorker;
+
+static bool arg_eq(const char *a, const char *b) {
+  return a && b && strcmp(a, b) == 0;
+}
+
+static void job_setup(StressJob *j, int i) {
+  j->w = 16 + 2 * (i % 8);
+  j->h = 12 + 2 * (i % 5);
+  j->seed = (unsigned int)i * 7u + 1u;
+  j->type = k_types[i % 4];
+}
+
+static bool out_alloc(StressOut *o, const StressJob *j) {
+  const long long text_len = snakebot_cycle_file_max_len(j->w, j->h);
+  const long long bin_len = snakebot_cycle_file_bin_size(j->w, j->h);
+  o->ws_len = snakebot_workspace_size(j->w, j->h);
+  o->text = (char *)malloc((size_t)text_len);
+  o->text_ws = (char *)malloc((size_t)text_len);
+  o->bin = (unsigned char *)malloc((size_t)bin_len);
+  o->bin_ws = (unsigned char *)malloc((size_t)bin_len);
+  o->cycle = (char *)malloc((size_t)j->w * (size_t)j->h + 1);
+  o->ws = malloc((size_t)o->ws_len);
+  return o->text && o->text_ws && o->bin && o->bin_ws && o->cycle && o->ws;
+}
+
+static void out_free(StressOut *o) {
+  free(o->text);
+  free(o->text_ws);
+  free(o->bin);
+  free(o->bin_ws);
+  free(o->cycle);
+  free(o->ws);
+  memset(o, 0, sizeof(*o));
+}
+
+// Runs every entry point for job j into o. Returns false (and logs) on the
+// first error.
+static bool job_run(const StressJob *j, StressOut *o) {
+  char err[STRESS_ERR_LEN];
+  const int text_len = (int)snakebot_cycle_file_max_len(j->w, j->h);
+  const long long bin_len = snakebot_cycle_file_bin_size(j->w, j->h);
+  const int cycle_len = j->w * j->h + 1;
+  const int win_w = j->w * 10, win_h = j->h * 10;
+  int ow = 0, oh = 0;
+  int rc;
+
+  if ((rc = snakebot_build_cycle_file_ex(j->w, j->h, win_w, win_h, j->seed,
+                                         j->type, o->text, text_len, err,
+                                         STRESS_ERR_LEN)) != 0 ||
+      (rc = snakebot_build_cycle_file_ex_ws(
+           j->w, j->h, win_w, win_h, j->seed, j->type, o->text_ws, text_len,
+           o->ws, o->ws_len, err, STRESS_ERR_LEN)) != 0 ||
+      (rc = snakebot_validate_cycle_file(o->text, &ow, &oh, err,
+                                         STRESS_ERR_LEN)) != 0 ||
+      (rc = snakebot_validate_cycle_file_ws(o->text_ws, &ow, &oh, o->ws,
+                                            o->ws_len, err,
+                                            STRESS_ERR_LEN)) != 0 ||
+      (rc = snakebot_build_cycle_file_bin(j->w, j->h, win_w, win_h, j->seed,
+                                          j->type, o->bin, bin_len, err,
+                                          STRESS_ERR_LEN)) != 0 ||
+      (rc = snakebot_build_cycle_file_bin_ws(
+           j->w, j->h, win_w, win_h, j->seed, j->type, o->bin_ws, bin_len,
+           o->ws, o->ws_len, err, STRESS_ERR_LEN)) != 0 ||
+      (rc = snakebot_validate_cycle_file_bin(o->bin, bin_len, &ow, &oh, err,
+                                             STRESS_ERR_LEN)) != 0 ||
+      (rc = snakebot_validate_cycle_file_bin_ws(o->bin_ws, bin_len, &ow, &oh,
+                                                o->ws, o->ws_len, err,
+                                                STRESS_ERR_LEN)) != 0 ||
+      (rc = snakebot_generate_cycle(j->w, j->h, o->cycle, cycle_len, err,
+                                    STRESS_ERR_LEN)) != 0 ||
+      (rc = snakebot_validate_cycle(j->w, j->h, o->cycle, err,
+                                    STRESS_ERR_LEN)) != 0) {
+    fprintf(stderr, "%dx%d %s seed %u: rc %d: %s\n", j->w, j->h, j->type,
+            j->seed, rc, err);
+    return false;
+  }
+  if (ow != j->w || oh != j->h) {
+    fprintf(stderr, "%dx%d %s seed %u: validated as %dx%d\n", j->w, j->h,
+            j->type, j->seed, ow, oh);
+    return false;
+  }
+  return true;
+}
+
+// Number of outputs in o that differ from the serial reference.
+static int job_compare(const StressJob *j, const StressOut *o) {
+  int bad = 0;
+  bad += strcmp(o->text, j->text) != 0;
+  bad += strcmp(o->text_ws, j->text) != 0;
+  bad += memcmp(o->bin, j->bin, (size_t)j->bin_len) != 0;
+  bad += memcmp(o->bin_ws, j->bin, (size_t)j->bin_len) != 0;
+  bad += strcmp(o->cycle, j->cycle) != 0;
+  return bad;
+}
+
+static void worker_run(StressWorker *wk) {
+  for (int r = 0; r < wk->rounds; r++) {
+    for (int i = wk->first; i < STRESS_JOBS; i += wk->step) {
+      const StressJob *j = &wk->jobs[i];
+      StressOut o = {0};
+      if (!out_alloc(&o, j) || !job_run(j, &o)) {
+        wk->errors++;
+      } else {
+        wk->mismatches += job_compare(j, &o);
+      }
+      out_free(&o);
+    }
+  }
+}
+
+#if defined(_WIN32)
+typedef HANDLE StressThread;
+
+static DWORD WINAPI stress_thread_main(LPVOID arg) {
+  worker_run((StressWorker *)arg);
+  return 0;
+}
+
+static bool stress_thread_start(StressThread *t, StressWorker *wk) {
+  *t = CreateThread(NULL, 0, stress_thread_main, wk, 0, NULL);
+  return *t != NULL;
+}
+
+static void stress_thread_join(StressThread t) {
+  WaitForSingleObject(t, INFINITE);
+  CloseHandle(t);
+}
+#else
+typedef pthread_t StressThread;
+
+static void *stress_thread_main(void *arg) {
+  worker_run((StressWorker *)arg);
+  return NULL;
+}
+
+static bool stress_thread_start(StressThread *t, StressWorker *wk) {
+  return pthread_create(t, NULL, stress_thread_main, wk) == 0;
+}
+
+static void stress_thread_join(StressThread t) { pthread_join(t, NULL); }
+#endif
+
+int main(int argc, char **argv) {
+  int threads = STRESS_THREADS;
+  int rounds = STRESS_ROUNDS;
+
+  for (int i = 1; i < argc; i++) {
+    if (arg_eq(argv[i], "--threads") && i + 1 < argc) {
+      threads = atoi(argv[++i]);
+    } else if (arg_eq(argv[i], "--rounds") && i + 1 < argc) {
+      rounds = atoi(argv[++i]);
+    } else {
+      fprintf(stderr, "usage: %s [--threads N] [--rounds N]\n", argv[0]);
+      return 2;
+    }
+  }
+  if (threads < 1)
+    threads = 1;
+  if (rounds < 1)
+    rounds = 1;
+
+  // Serial reference pass.
+  static StressJob jobs[STRESS_JOBS];
+  for (int i = 0; i < STRESS_JOBS; i++) {
+    StressJob *j = &jobs[i];
+    job_setup(j, i);
+    StressOut o = {0};
+    if (!out_alloc(&o, j) || !job_run(j, &o)) {
+      fprintf(stderr, "serial pass failed on job %d\n", i);
+      return 1;
+    }
+    j->bin_len = snakebot_cycle_file_bin_size(j->w, j->h);
+    // The *_ws outputs must already match the plain entry points.
+    if (strcmp(o.text_ws, o.text) != 0 ||
+        memcmp(o.bin_ws, o.bin, (size_t)j->bin_len) != 0) {
+      fprintf(stderr, "job %d: *_ws output differs from the plain call\n", i);
+      return 1;
+    }
+    j->text = o.text;
+    j->bin = o.bin;
+    j->cycle = o.cycle;
+    o.text = NULL;
+    o.bin = NULL;
+    o.cycle = NULL;
+    out_free(&o);
+  }
+
+  StressWorker *wk = (StressWorker *)calloc((size_t)threads, sizeof(*wk));
+  StressThread *th = (StressThread *)calloc((size_t)threads, sizeof(*th));
+  if (!wk || !th) {
+    fprintf(stderr, "out of memory\n");
+    return 1;
+  }
+
+  // Overlapping job strides so threads run the same jobs at the same time.
+  const int step = threads > 3 ? 3 : threads;
+  int started = 0;
+  for (int t = 0; t < threads; t++) {
+    wk[t].jobs = jobs;
+    wk[t].first = t % step;
+    wk[t].step = step;
+    wk[t].rounds = rounds;
+    if (!stress_thread_start(&th[t], &wk[t])) {
+      fprintf(stderr, "thread %d failed to start\n", t);
+      break;
+    }
+    started++;
+  }
+
+  int mismatches = 0, errors = 0;
+  for (int t = 0; t < started; t++) {
+    stress_thread_join(th[t]);
+    mismatches += wk[t].mismatches;
+    errors += wk[t].errors;
+  }
+
+  printf("botlib_stress: %d threads x %d rounds over %d jobs: %d mismatches, "
+         "%d errors\n",
+         started, rounds, STRESS_JOBS, mismatches, errors);
+
+  for (int i = 0; i < STRESS_JOBS; i++) {
+    free(jobs[i].text);
+    free(jobs[i].bin);
+    free(jobs[i].cycle);
+  }
+  free(wk);
+  free(th);
+  return (started == threads && mismatches == 0 && errors == 0) ? 0 : 1;
+}
@@ -0,0 +1,457 @@
+#include "cycle_file.h"
+
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+static void set_err(char *err, int err_len, const char *msg) {
+  if (err && err_len > 0)
+    snprintf(err, (size_t)err_len, "%s", msg);
+}
+
+static uint32_t get_u32(const uint8_t *p) {
+  return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) |
+         ((uint32_t)p[3] << 24);
+}
+
+static void put_u32(uint8_t *p, uint32_t v) {
+  p[0] = (uint8_t)v;
+  p[1] = (uint8_t)(v >> 8);
+  p[2] = (uint8_t)(v >> 16);
+  p[3] = (uint8_t)(v >> 24);
+}
+
+// ------------------------------------------------------------
+// File mapping
+// ------------------------------------------------------------
+
+// Fallback when the file can't be mapped (pipes, odd filesystems): read it
+// into a heap buffer. handle stays NULL so Unmap knows to free it.
+static bool read_whole_file(CycleFileMap *m, const char *path) {
+  FILE *f = fopen(path, "rb");
+  if (!f)
+    return false;
+  fseek(f, 0, SEEK_END);
+  long sz = ftell(f);
+  fseek(f, 0, SEEK_SET);
+  if (sz <= 0) {
+    fclose(f);
+    return false;
+  }
+  uint8_t *buf = (uint8_t *)malloc((size_t)sz);
+  if (!buf) {
+    fclose(f);
+    return false;
+  }
+  size_t got = fread(buf, 1, (size_t)sz, f);
+  fclose(f);
+  m->data = buf;
+  m->size = got;
+  m->handle = NULL;
+  return got > 0;
+}
+
+bool CycleFile_Map(CycleFileMap *m, const char *path) {
+  if (!m || !path)
+    return false;
+  memset(m, 0, sizeof(*m));
+
+#if defined(_WIN32)
+  HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL,
+                            OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+  if (file == INVALID_HANDLE_VALUE)
+    return false;
+  LARGE_INTEGER sz;
+  if (!GetFileSizeEx(file, &sz) || sz.QuadPart <= 0) {
+    CloseHandle(file);
+    return false;
+  }
+  HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+  CloseHandle(file);
+  if (mapping) {
+    const void *view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (view) {
+      m->data = (const uint8_t *)view;
+      m->size = (size_t)sz.QuadPart;
+      m->handle = mapping;
+      return true;
+    }
+    CloseHandle(mapping);
+  }
+#else
+  int fd = open(path, O_RDONLY);
+  if (fd < 0)
+    return false;
+  struct stat st;
+  if (fstat(fd, &st) != 0 || st.st_size <= 0) {
+    close(fd);
+    return false;
+  }
+  void *view = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (view != MAP_FAILED) {
+    m->data = (const uint8_t *)view;
+    m->size = (size_t)st.st_size;
+    m->handle = view;
+    return true;
+  }
+#endif
+
+  return read_whole_file(m, path);
+}
+
+void CycleFile_Unmap(CycleFileMap *m) {
+  if (!m || !m->data)
+    return;
+  if (!m->handle) {
+    free((void *)m->data);
+  } else {
+#if defined(_WIN32)
+    UnmapViewOfFile(m->data);
+    CloseHandle((HANDLE)m->handle);
+#else
+    munmap((void *)m->data, m->size);
+#endif
+  }
+  memset(m, 0, sizeof(*m));
+}
+
+// ------------------------------------------------------------
+// Binary container (SNAKECYCLE 2)
+// ------------------------------------------------------------
+
+long long CycleFile_BinSize(int w, int h) {
+  if (w <= 0 || h <= 0 || w > INT_MAX / h)
+    return -1;
+  return CYCLE_BIN_HEADER_SIZE + ((long long)w * h + 3) / 4;
+}
+
+void CycleFile_WriteBinHeader(uint8_t *out, const CycleFileMeta *meta) {
+  memset(out, 0, CYCLE_BIN_HEADER_SIZE);
+  memcpy(out, CYCLE_BIN_MAGIC, sizeof(CYCLE_BIN_MAGIC) - 1);
+  put_u32(out + 16, (uint32_t)meta->width);
+  put_u32(out + 20, (uint32_t)meta->height);
+  put_u32(out + 24, (uint32_t)meta->window_w);
+  put_u32(out + 28, (uint32_t)meta->window_h);
+  put_u32(out + 32, meta->seed);
+  put_u32(out + 36, meta->wrap > 0 ? CYCLE_BIN_FLAG_WRAP : 0u);
+  put_u32(out + 40, CYCLE_BIN_HEADER_SIZE);
+  // Leave the last byte as a terminator.
+  const char *nul = memchr(meta->cycle_type, '\0', 15);
+  size_t tlen = nul ? (size_t)(nul - meta->cycle_type) : 15;
+  memcpy(out + 48, meta->cycle_type, tlen);
+}
+
+static bool is_bin(const uint8_t *d, size_t size) {
+  const size_t mlen = sizeof(CYCLE_BIN_MAGIC) - 1;
+  return size >= mlen && memcmp(d, CYCLE_BIN_MAGIC, mlen) == 0;
+}
+
+static bool parse_bin_meta(const uint8_t *d, size_t size, CycleFileMeta *meta,
+                           size_t *data_off, char *err, int err_len) {
+  if (size < CYCLE_BIN_HEADER_SIZE) {
+    set_err(err, err_len, "binary header is truncated");
+    return false;
+  }
+  uint32_t w = get_u32(d + 16);
+  uint32_t h = get_u32(d + 20);
+  uint32_t off = get_u32(d + 40);
+  if (w == 0 || h == 0 || w > INT_MAX || h > INT_MAX ||
+      CycleFile_BinSize((int)w, (int)h) < 0) {
+    set_err(err, err_len, "missing/invalid width or height metadata");
+    return false;
+  }
+  if (off < CYCLE_BIN_HEADER_SIZE || off > size) {
+    set_err(err, err_len, "invalid data offset");
+    return false;
+  }
+  if ((long long)(size - off) < ((long long)w * h + 3) / 4) {
+    set_err(err, err_len, "cycle data is truncated");
+    return false;
+  }
+
+  uint32_t ww = get_u32(d + 24);
+  uint32_t wh = get_u32(d + 28);
+  meta->width = (int)w;
+  meta->height = (int)h;
+  meta->window_w = (ww > 0 && ww <= INT_MAX) ? (int)ww : -1;
+  meta->window_h = (wh > 0 && wh <= INT_MAX) ? (int)wh : -1;
+  meta->seed = get_u32(d + 32);
+  meta->wrap = (get_u32(d + 36) & CYCLE_BIN_FLAG_WRAP) ? 1 : 0;
+  memcpy(meta->cycle_type, d + 48, 15);
+  meta->cycle_type[15] = '\0';
+  *data_off = off;
+  return true;
+}
+
+// ------------------------------------------------------------
+// Text container (SNAKECYCLE 1)
+// ------------------------------------------------------------
+
+static bool is_space(uint8_t c) {
+  return c == ' ' || c == '\t' || c == '\r' || c == '\n' || c == '\v' ||
+         c == '\f';
+}
+
+// Returns the next line as [*ls, *le) with surrounding blanks trimmed, and
+// moves *pos past its line break.
+static bool next_line(const uint8_t *d, size_t size, size_t *pos, size_t *ls,
+                      size_t *le) {
+  size_t i = *pos;
+  if (i >= size)
+    return false;
+  size_t s = i;
+  while (i < size && d[i] != '\n' && d[i] != '\r')
+    i++;
+  size_t e = i;
+  if (i < size && d[i] == '\r')
+    i++;
+  if (i < size && d[i] == '\n')
+    i++;
+  *pos = i;
+  while (s < e && (d[s] == ' ' || d[s] == '\t'))
+    s++;
+  while (e > s && (d[e - 1] == ' ' || d[e - 1] == '\t'))
+    e--;
+  *ls = s;
+  *le = e;
+  return true;
+}
+
+static bool span_eq(const uint8_t *d, size_t s, size_t e, const char *lit) {
+  size_t n = strlen(lit);
+  return e - s == n && memcmp(d + s, lit, n) == 0;
+}
+
+// Integer values are clamped to -1 when absent or out of range.
+static long long parse_value(const uint8_t *d, size_t s, size_t e) {
+  char buf[32];
+  size_t n = e - s;
+  if (n == 0 || n >= sizeof(buf))
+    return -1;
+  memcpy(buf, d + s, n);
+  buf[n] = '\0';
+  char *end = NULL;
+  long long v = strtoll(buf, &end, 10);
+  return (end == buf) ? -1 : v;
+}
+
+static int as_int(long long v) {
+  return (v >= 0 && v <= INT_MAX) ? (int)v : -1;
+}
+
+static bool parse_text_meta(const uint8_t *d, size_t size, CycleFileMeta *meta,
+                            size_t *data_off, char *err, int err_len) {
+  size_t pos = 0;
+  while (pos < size && is_space(d[pos]))
+    pos++;
+  size_t ls, le;
+  if (!next_line(d, size, &pos, &ls, &le) ||
+      !span_eq(d, ls, le, CYCLE_TEXT_MAGIC)) {
+    set_err(err, err_len,
+            "invalid header (expected 'SNAKECYCLE 1' or 'SNAKECYCLE 2')");
+    return false;
+  }
+
+  long long w = -1, h = -1;
+  bool have_data = false;
+  while (next_line(d, size, &pos, &ls, &le)) {
+    if (ls == le || d[ls] == '#')
+      continue;
+    if (span_eq(d, ls, le, "DATA")) {
+      have_data = true;
+      break;
+    }
+    const uint8_t *eq = memchr(d + ls, '=', le - ls);
+    if (!eq)
+      continue;
+    size_t ke = (size_t)(eq - d);
+    size_t vs = ke + 1;
+    while (ke > ls && (d[ke - 1] == ' ' || d[ke - 1] == '\t'))
+      ke--;
+    while (vs < le && (d[vs] == ' ' || d[vs] == '\t'))
+      vs++;
+
+    if (span_eq(d, ls, ke, "width")) {
+      w = parse_value(d, vs, le);
+    } else if (span_eq(d, ls, ke, "height")) {
+      h = parse_value(d, vs, le);
+    } else if (span_eq(d, ls, ke, "window_w")) {
+      meta->window_w = as_int(parse_value(d, vs, le));
+    } else if (span_eq(d, ls, ke, "window_h")) {
+      meta->window_h = as_int(parse_value(d, vs, le));
+    } else if (span_eq(d, ls, ke, "seed")) {
+      long long v = parse_value(d, vs, le);
+      meta->seed = (v > 0 && v <= (long long)UINT_MAX) ? (unsigned int)v : 0u;
+    } else if (span_eq(d, ls, ke, "wrap")) {
+      long long v = parse_value(d, vs, le);
+      meta->wrap = (v < 0) ? -1 : (v != 0);
+    } else if (span_eq(d, ls, ke, "cycle_type")) {
+      size_t n = le - vs;
+      if (n >= sizeof(meta->cycle_type))
+        n = sizeof(meta->cycle_type) - 1;
+      memcpy(meta->cycle_type, d + vs, n);
+      meta->cycle_type[n] = '\0';
+    }
+  }
+
+  if (!have_data) {
+    set_err(err, err_len, "missing DATA section");
+    return false;
+  }
+  if (as_int(w) <= 0 || as_int(h) <= 0 ||
+      CycleFile_BinSize((int)w, (int)h) < 0) {
+    set_err(err, err_len, "missing/invalid width or height metadata");
+    return false;
+  }
+  // Every cell needs at least one byte, which also bounds what callers
+  // allocate for a hostile header.
+  if (w * h > (long long)(size - pos)) {
+    set_err(err, err_len, "cycle data is truncated");
+    return false;
+  }
+  meta->width = (int)w;
+  meta->height = (int)h;
+  *data_off = pos;
+  return true;
+}
+
+// ------------------------------------------------------------
+// Shared parser
+// ------------------------------------------------------------
+
+bool CycleFile_ParseMeta(const void *data, size_t size, CycleFileMeta *meta,
+                         size_t *data_off, char *err, int err_len) {
+  if (!data || !meta || !data_off) {
+    set_err(err, err_len, "cycle file data must be non-null");
+    return false;
+  }
+  memset(meta, 0, sizeof(*meta));
+  meta->window_w = -1;
+  meta->window_h = -1;
+  meta->wrap = -1;
+
+  const uint8_t *d = (const uint8_t *)data;
+  if (is_bin(d, size))
+    return parse_bin_meta(d, size, meta, data_off, err, err_len);
+  return parse_text_meta(d, size, meta, data_off, err, err_len);
+}
+
+bool CycleFile_DecodeDirs(const void *data, size_t size,
+                          const CycleFileMeta *meta, size_t data_off,
+                          uint8_t *dirs, char *err, int err_len) {
+  const uint8_t *d = (const uint8_t *)data;
+  const int n = meta->width * meta->height;
+
+  if (is_bin(d, size)) {
+    // Bounds were checked by ParseMeta; four cells per byte.
+    const uint8_t *packed = d + data_off;
+    int i = 0;
+    for (; i + 4 <= n; i += 4) {
+      const uint8_t v = packed[i >> 2];
+      dirs[i] = (uint8_t)(v & 3);
+      dirs[i + 1] = (uint8_t)((v >> 2) & 3);
+      dirs[i + 2] = (uint8_t)((v >> 4) & 3);
+      dirs[i + 3] = (uint8_t)(v >> 6);
+    }
+    for (; i < n; i++)
+      dirs[i] = (uint8_t)CycleFile_GetCode(packed, i);
+    return true;
+  }
+
+  int got = 0;
+  for (size_t i = data_off; i < size; i++) {
+    uint8_t c = d[i];
+    int code;
+    switch (c) {
+    case 'U':
+    case 'u':
+      code = 0;
+      break;
+    case 'D':
+    case 'd':
+      code = 1;
+      break;
+    case 'L':
+    case 'l':
+      code = 2;
+      break;
+    case 'R':
+    case 'r':
+      code = 3;
+      break;
+    default:
+      if (is_space(c))
+        continue;
+      set_err(err, err_len,
+              "cycle contains invalid direction (expected U/D/L/R)");
+      return false;
+    }
+    if (got == n) {
+      set_err(err, err_len, "cycle contains more than w*h direction letters");
+      return false;
+    }
+    dirs[got++] = (uint8_t)code;
+  }
+  if (got != n) {
+    set_err(err, err_len,
+            "cycle must contain exactly w*h direction letters (whitespace "
+            "ignored)");
+    return false;
+  }
+  return true;
+}
+
+bool CycleFile_Load(CycleFile *cf, const char *path, char *err, int err_len) {
+  if (!cf || !path) {
+    set_err(err, err_len, "invalid cycle path");
+    return false;
+  }
+  memset(cf, 0, sizeof(*cf));
+  size_t plen = strlen(path);
+  if (plen < 6 || strcmp(path + plen - 6, ".cycle") != 0) {
+    set_err(err, err_len, "cycle path must end with .cycle");
+    return false;
+  }
+
+  CycleFileMap map;
+  if (!CycleFile_Map(&map, path)) {
+    set_err(err, err_len, "failed to open cycle file (or it is empty)");
+    return false;
+  }
+  size_t data_off = 0;
+  bool ok = CycleFile_ParseMeta(map.data, map.size, &cf->meta, &data_off, err,
+                                err_len);
+  if (ok) {
+    cf->dirs = (uint8_t *)malloc(
+        (size_t)cf->meta.width * (size_t)cf->meta.height);
+    if (!cf->dirs) {
+      set_err(err, err_len, "out of memory reading cycle file");
+      ok = false;
+    }
+  }
+  if (ok)
+    ok = CycleFile_DecodeDirs(map.data, map.size, &cf->meta, data_off,
+                              cf->dirs, err, err_len);
+  CycleFile_Unmap(&map);
+  if (!ok)
+    CycleFile_Free(cf);
+  return ok;
+}
+
+void CycleFile_Free(CycleFile *cf) {
+  if (!cf)
+    return;
+  free(cf->dirs);
+  cf->dirs = NULL;
+}
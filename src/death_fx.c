@@ -1,5 +1,4 @@
 #include "death_fx.h"
-#include "render.h"
 #include <math.h>
 #include <stdbool.h>
 
@@ -8,6 +7,8 @@
  * death_fx.c
  * Disintegration effect rendered after death.
  * Captures interpolation state at death to avoid visual popping.
+ * All segment quads are built into frame-arena buffers and submitted with a
+ * single SDL_RenderGeometry call per frame.
  */
 
 typedef struct { float x, y; } FVec2;
@@ -44,7 +45,6 @@ static FVec2 grid_to_px_center(const App* app, float gx, float gy) {
     return c;
 }
 
-// Tiny integer hash used to derive deterministic per-segment "random" values.
 // Tiny integer hash used to derive deterministic per-segment "random" values.
 static uint32_t hash_u32(uint32_t x) {
     x ^= x >> 16;
@@ -85,8 +85,8 @@ void DeathFx_Start(DeathFx* fx, bool interp_mode, float death_alpha, uint64_t no
     fx->seed = (uint32_t)(now_ns ^ (now_ns >> 32) ^ 0xA5A5A5A5U);
 }
 
-void DeathFx_RenderAndAdvance(DeathFx* fx, const App* app, const Snake* snake, uint64_t now_ns) {
-    if (!fx || !app || !snake || !fx->active || fx->finished) return;
+void DeathFx_RenderAndAdvance(DeathFx* fx, App* app, const Snake* snake, uint64_t now_ns) {
+    if (!fx || !app || !app->renderer || !snake || !fx->active || fx->finished) return;
 
     float t = (float)((double)(now_ns - fx->start_ns) / 1e9);
 
@@ -99,52 +99,112 @@ void DeathFx_RenderAndAdvance(DeathFx* fx, const App* app, const Snake* snake, u
         return;
     }
 
-    const uint8_t base_r = 0, base_g = 200, base_b = 0;
+    // Segments animate head-to-tail with a stagger, so everything before
+    // `first` has already fully disintegrated. Start one early to stay safe
+    // against rounding; the p >= 1 check below drops it if needed.
+    int first = 0;
+    if (fx->stagger_s > 0.0f && t > fx->seg_dur_s) {
+        first = (int)((t - fx->seg_dur_s) / fx->stagger_s);
+        if (first > 0) first--;
+    }
+    const int n = snake->len - first;
+    if (n <= 0) return;
+
+    // Structure-of-arrays scratch for this frame (see frame_arena.h).
+    FrameArena* arena = &app->frame_arena;
+    float* cx = (float*)FrameArena_Alloc(arena, (size_t)n * sizeof(float));
+    float* cy = (float*)FrameArena_Alloc(arena, (size_t)n * sizeof(float));
+    float* prog = (float*)FrameArena_Alloc(arena, (size_t)n * sizeof(float));
+    SDL_Vertex* verts = (SDL_Vertex*)FrameArena_Alloc(arena, (size_t)n * 4 * sizeof(SDL_Vertex));
+    int* idx = (int*)FrameArena_Alloc(arena, (size_t)n * 6 * sizeof(int));
+    if (!cx || !cy || !prog || !verts || !idx) return;
+
+    // Pass 1: gather centers (the only pass that touches the snake).
+    const float a = fx->death_alpha;
+    for (int k = 0; k < n; k++) {
+        int i = first + k;
+        float gx, gy;
+        IVec2 seg = Snake_Seg(snake, i);
+        // Position based on interp mode frozen at death time
+        if (fx->interp_mode) {
+            IVec2 prev = Snake_Prev(snake, i);
+            gx = wrap_interp((float)prev.x, (float)seg.x, snake->grid_w, a);
+            gy = wrap_interp((float)prev.y, (float)seg.y, snake->grid_h, a);
+        } else {
+            gx = (float)seg.x;
+            gy = (float)seg.y;
+        }
+        FVec2 c = grid_to_px_center(app, gx, gy);
+        cx[k] = c.x;
+        cy[k] = c.y;
+    }
+
+    // Pass 2: per-segment progress, branch-free.
+    const float inv_dur = 1.0f / fx->seg_dur_s;
+    for (int k = 0; k < n; k++) {
+        float ti = t - (float)(first + k) * fx->stagger_s;
+        prog[k] = clamp01f(ti * inv_dur);
+    }
 
-    // Animate head-to-tail with a stagger so the snake breaks apart progressively.
-    for (int i = 0; i < snake->len; i++) {
-        float ti = t - (float)i * fx->stagger_s;
-        float p = clamp01f(ti / fx->seg_dur_s);
+    // Pass 3: build quads for segments still visible.
+    const float cell_w = (float)app->cell_w;
+    const float cell_h = (float)app->cell_h;
+    const float max_rot_rad = deg_to_rad(fx->max_rot_deg);
+    const float base_r = 0.0f, base_g = 200.0f / 255.0f, base_b = 0.0f;
+    int quads = 0;
 
-        if (ti < 0.0f) p = 0.0f;
+    for (int k = 0; k < n; k++) {
+        float p = prog[k];
         if (p >= 1.0f) continue;
 
         // Scale + fade (with gentle easing)
-        float scale = 1.0f - p;
-        float fade  = 1.0f - p;
-
-        scale = scale * scale;
-        fade  = fade * (1.0f - 0.15f * p);
+        float scale = (1.0f - p) * (1.0f - p);
+        float fade  = (1.0f - p) * (1.0f - 0.15f * p);
 
         // Rotation target: deterministic per segment
-        uint32_t h = hash_u32((uint32_t)i ^ fx->seed);
+        uint32_t h = hash_u32((uint32_t)(first + k) ^ fx->seed);
         float u = (float)(h & 0xFFFF) / 65535.0f;   // 0..1
-        float target_deg = (u * 2.0f - 1.0f) * fx->max_rot_deg;
 
         // IMPORTANT: rotation should not appear instantly.
         // Ease rotation in as the segment disintegrates.
-        float rot_t = smoothstep01((p - 0.25f) / 0.75f);
-        float rot_deg = target_deg * rot_t;
-
-        // Position based on interp mode frozen at death time
-        float gx, gy;
-        if (fx->interp_mode) {
-            float a = fx->death_alpha;
-            gx = wrap_interp((float)snake->prev[i].x, (float)snake->seg[i].x, snake->grid_w, a);
-            gy = wrap_interp((float)snake->prev[i].y, (float)snake->seg[i].y, snake->grid_h, a);
-        } else {
-            gx = (float)snake->seg[i].x;
-            gy = (float)snake->seg[i].y;
+        float rot = (u * 2.0f - 1.0f) * max_rot_rad * smoothstep01((p - 0.25f) / 0.75f);
+
+        float c = cosf(rot);
+        float s = sinf(rot);
+        float hw = cell_w * scale * 0.5f;
+        float hh = cell_h * scale * 0.5f;
+
+        // Corner offsets rotated by (c, s): TL, TR, BR, BL
+        float ax = hw * c, ay = hw * s;
+        float bx = hh * s, by = hh * c;
+
+        SDL_Vertex* v = &verts[quads * 4];
+        v[0].position.x = cx[k] - ax + bx;  v[0].position.y = cy[k] - ay - by;
+        v[1].position.x = cx[k] + ax + bx;  v[1].position.y = cy[k] + ay - by;
+        v[2].position.x = cx[k] + ax - bx;  v[2].position.y = cy[k] + ay + by;
+        v[3].position.x = cx[k] - ax - bx;  v[3].position.y = cy[k] - ay + by;
+
+        float alpha = clamp01f(fade);
+        for (int j = 0; j < 4; j++) {
+            v[j].color.r = base_r;
+            v[j].color.g = base_g;
+            v[j].color.b = base_b;
+            v[j].color.a = alpha;
+            v[j].tex_coord.x = 0.0f;
+            v[j].tex_coord.y = 0.0f;
         }
 
-        FVec2 c = grid_to_px_center(app, gx, gy);
+        int* q = &idx[quads * 6];
+        int base = quads * 4;
+        q[0] = base;     q[1] = base + 1; q[2] = base + 2;
+        q[3] = base;     q[4] = base + 2; q[5] = base + 3;
 
-        float w = (float)app->cell_w * scale;
-        float hgt = (float)app->cell_h * scale;
+        quads++;
+    }
 
-        uint8_t a8 = (uint8_t)(255.0f * clamp01f(fade));
+    if (quads == 0) return;
 
-        Render_QuadCenteredPx(app, c.x, c.y, w, hgt, deg_to_rad(rot_deg),
-                              base_r, base_g, base_b, a8);
-    }
+    // One submission for the whole snake.
+    SDL_SetRenderDrawBlendMode(app->renderer, SDL_BLENDMODE_BLEND);
+    SDL_RenderGeometry(app->renderer, NULL, verts, quads * 4, idx, quads * 6);
 }
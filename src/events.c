@@ -23,6 +23,7 @@ void Events_Poll(EventsFrame* out) {
     out->toggle_interp = false; // NEW
     out->dir_count = 0;
     out->continue_game = false;
+    out->render_reset = false;
 
     SDL_Event e;
     while (SDL_PollEvent(&e)) {
@@ -31,6 +32,12 @@ void Events_Poll(EventsFrame* out) {
                 out->quit = true;
                 break;
 
+            case SDL_EVENT_WINDOW_PIXEL_SIZE_CHANGED:
+            case SDL_EVENT_RENDER_TARGETS_RESET:
+            case SDL_EVENT_RENDER_DEVICE_RESET:
+                out->render_reset = true;
+                break;
+
             case SDL_EVENT_KEY_DOWN: {
                 if (e.key.repeat) break;
 
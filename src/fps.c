@@ -6,11 +6,13 @@
  * fps.c
  * FPS/TPS tracking for diagnostics and window title.
  *
- * We recompute fps/tps about once per second to reduce noise, but we still
- * rewrite the title every call so end-state titles remain authoritative.
+ * We recompute fps/tps about once per second to reduce noise. Title calls
+ * compare their inputs with the cached ones first, so an unchanged frame
+ * costs a few compares instead of an snprintf and a window-system call.
  */
 
 #include <stdio.h>
+#include <string.h>
 
 void Fps_Init(FpsCounter* c) {
     if (!c) return;
@@ -20,6 +22,20 @@ void Fps_Init(FpsCounter* c) {
     c->tick_count  = 0;
     c->fps = 0.0;
     c->tps = 0.0;
+
+    for (int i = 0; i < FPS_HIST_COUNT; i++) {
+        Histogram_Reset(&c->hist[i]);
+    }
+
+    c->title[0] = '\0';
+    c->title_kind = -1;
+    c->title_score = 0;
+    c->title_fps = 0.0;
+    c->title_tps = 0.0;
+    c->title_interp = false;
+    c->title_pushed_ns = 0;
+    c->title_updates = 0;
+    c->title_skipped = 0;
 }
 
 void Fps_OnFrame(FpsCounter* c) {
@@ -32,6 +48,104 @@ void Fps_OnTick(FpsCounter* c) {
     c->tick_count++;
 }
 
+void Fps_AddTicks(FpsCounter* c, int n) {
+    if (!c || n <= 0) return;
+    c->tick_count += n;
+}
+
+static const char* hist_name(FpsHist which) {
+    switch (which) {
+        case FPS_HIST_FRAME:   return "frame";
+        case FPS_HIST_RENDER:  return "render";
+        case FPS_HIST_PRESENT: return "present";
+        case FPS_HIST_SIM:     return "sim tick";
+        case FPS_HIST_BOT:     return "bot decision";
+        default:               return "?";
+    }
+}
+
+static bool hist_valid(FpsHist which) {
+    return (int)which >= 0 && which < FPS_HIST_COUNT;
+}
+
+void Fps_Record(FpsCounter* c, FpsHist which, uint64_t ns) {
+    if (!c || !hist_valid(which)) return;
+    Histogram_Record(&c->hist[which], ns);
+}
+
+void Fps_MergeHistogram(FpsCounter* c, FpsHist which, const Histogram* h) {
+    if (!c || !h || !hist_valid(which)) return;
+    Histogram_Merge(&c->hist[which], h);
+}
+
+FpsPercentiles Fps_GetPercentiles(const FpsCounter* c, FpsHist which) {
+    FpsPercentiles p = {0};
+    if (!c || !hist_valid(which)) return p;
+
+    const Histogram* h = &c->hist[which];
+    p.count  = h->count;
+    p.p50_ns = Histogram_Percentile(h, 0.50);
+    p.p95_ns = Histogram_Percentile(h, 0.95);
+    p.p99_ns = Histogram_Percentile(h, 0.99);
+    p.max_ns = h->max_ns;
+    return p;
+}
+
+void Fps_LogHistograms(const FpsCounter* c) {
+    if (!c) return;
+
+    for (int i = 0; i < FPS_HIST_COUNT; i++) {
+        FpsPercentiles p = Fps_GetPercentiles(c, (FpsHist)i);
+        if (p.count == 0) continue;
+
+        SDL_Log("%-12s p50 %9.3f us | p95 %9.3f us | p99 %9.3f us | "
+                "max %9.3f us | n %llu",
+                hist_name((FpsHist)i),
+                (double)p.p50_ns / 1000.0, (double)p.p95_ns / 1000.0,
+                (double)p.p99_ns / 1000.0, (double)p.max_ns / 1000.0,
+                (unsigned long long)p.count);
+    }
+}
+
+// Which title format is showing.
+enum {
+    TITLE_PLAYING = 0,
+    TITLE_GAME_OVER,
+    TITLE_YOU_WIN,
+    TITLE_END_GAME_OVER,   // Fps_SetEndTitle variants
+    TITLE_END_YOU_WIN
+};
+
+// Whether the title has to be reformatted for these inputs.
+static bool title_due(const FpsCounter* c, int kind, int score,
+                      bool interp_on, uint64_t now) {
+    if (c->title_kind != kind || c->title_interp != interp_on) return true;
+    if (c->title_score == score &&
+        c->title_fps == c->fps && c->title_tps == c->tps) {
+        return false;
+    }
+    return now - c->title_pushed_ns >= FPS_TITLE_MIN_INTERVAL_NS;
+}
+
+static void push_title(FpsCounter* c, SDL_Window* window, const char* title,
+                       int kind, int score, bool interp_on, uint64_t now) {
+    c->title_kind = kind;
+    c->title_score = score;
+    c->title_fps = c->fps;
+    c->title_tps = c->tps;
+    c->title_interp = interp_on;
+    c->title_pushed_ns = now;
+
+    // Same inputs can still format to the same text (fps to one decimal).
+    if (strcmp(title, c->title) == 0) {
+        c->title_skipped++;
+        return;
+    }
+    SDL_strlcpy(c->title, title, sizeof(c->title));
+    SDL_SetWindowTitle(window, c->title);
+    c->title_updates++;
+}
+
 void Fps_UpdateWindowTitle(FpsCounter* c, SDL_Window* window,
                            bool interp_on, int score,
                            bool game_over, bool you_win) {
@@ -52,8 +166,14 @@ void Fps_UpdateWindowTitle(FpsCounter* c, SDL_Window* window,
         c->last_sample_ns = now;
     }
 
-    // Always write the title using the *current* game state.
-    // This prevents end-state strings from being overwritten by a stale title.
+    const int kind = you_win ? TITLE_YOU_WIN
+                   : game_over ? TITLE_GAME_OVER
+                   : TITLE_PLAYING;
+    if (!title_due(c, kind, score, interp_on, now)) {
+        c->title_skipped++;
+        return;
+    }
+
     char title[260];
 
     if (you_win) {
@@ -79,5 +199,23 @@ void Fps_UpdateWindowTitle(FpsCounter* c, SDL_Window* window,
         );
     }
 
-    SDL_SetWindowTitle(window, title);
+    push_title(c, window, title, kind, score, interp_on, now);
+}
+
+void Fps_SetEndTitle(FpsCounter* c, SDL_Window* window,
+                     bool you_win, int score) {
+    if (!c || !window) return;
+
+    uint64_t now = SDL_GetTicksNS();
+    const int kind = you_win ? TITLE_END_YOU_WIN : TITLE_END_GAME_OVER;
+    if (!title_due(c, kind, score, c->title_interp, now)) {
+        c->title_skipped++;
+        return;
+    }
+
+    char title[260];
+    snprintf(title, sizeof(title),
+             "snake-sdl | %s - Continue? (L) | Score: %d",
+             you_win ? "YOU WIN!" : "GAME OVER", score);
+    push_title(c, window, title, kind, score, c->title_interp, now);
 }
@@ -0,0 +1,84 @@
+#include "frame_arena.h"
+#include <stdlib.h>
+
+
+/*
+ * frame_arena.c
+ * Grow-only bump allocator reset once per frame.
+ */
+
+
+#define FRAME_ARENA_ALIGN 16
+#define FRAME_ARENA_MIN_CAP 4096
+
+struct FrameArenaBlock {
+    FrameArenaBlock* next;
+    // Pads the header so the payload after it keeps FRAME_ARENA_ALIGN.
+    unsigned char pad[FRAME_ARENA_ALIGN - sizeof(void*)];
+};
+
+static size_t align_up(size_t n) {
+    return (n + (FRAME_ARENA_ALIGN - 1)) & ~(size_t)(FRAME_ARENA_ALIGN - 1);
+}
+
+static void free_overflow(FrameArena* a) {
+    FrameArenaBlock* blk = a->overflow;
+    while (blk) {
+        FrameArenaBlock* next = blk->next;
+        free(blk);
+        blk = next;
+    }
+    a->overflow = NULL;
+}
+
+void FrameArena_Reset(FrameArena* a) {
+    if (!a) return;
+
+    free_overflow(a);
+
+    if (a->peak > a->cap) {
+        size_t new_cap = (a->cap > 0) ? a->cap : FRAME_ARENA_MIN_CAP;
+        while (new_cap < a->peak) new_cap *= 2;
+
+        // Contents are dead after a reset, so free + malloc instead of realloc.
+        free(a->base);
+        a->base = (unsigned char*)malloc(new_cap);
+        a->cap = a->base ? new_cap : 0;
+        a->heap_allocs++;
+    }
+
+    a->used = 0;
+    a->peak = 0;
+}
+
+void* FrameArena_Alloc(FrameArena* a, size_t size) {
+    if (!a) return NULL;
+
+    size = align_up(size ? size : 1);
+    a->peak += size;
+
+    if (a->base && size <= a->cap - a->used) {
+        void* p = a->base + a->used;
+        a->used += size;
+        return p;
+    }
+
+    // Doesn't fit this frame: hand out a temporary block, freed on reset.
+    FrameArenaBlock* blk = (FrameArenaBlock*)malloc(sizeof(*blk) + size);
+    if (!blk) return NULL;
+    a->heap_allocs++;
+
+    blk->next = a->overflow;
+    a->overflow = blk;
+    return blk + 1;
+}
+
+void FrameArena_Destroy(FrameArena* a) {
+    if (!a) return;
+    free_overflow(a);
+    free(a->base);
+    a->base = NULL;
+    a->cap = 0;
+    a->used = 0;
+    a->peak = 0;
+}
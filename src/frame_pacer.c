@@ -0,0 +1,52 @@
+#include "frame_pacer.h"
+
+
+/*
+ * frame_pacer.c
+ * Hybrid sleep + spin frame cap.
+ */
+
+
+void FramePacer_Init(FramePacer* p, SDL_Renderer* renderer, uint64_t frame_ns,
+                     bool want_vsync) {
+    if (!p) return;
+
+    p->frame_ns = frame_ns;
+    p->spin_ns = FRAME_PACER_SPIN_NS;
+    p->vsync = false;
+    p->last_frame_start = 0;
+    Histogram_Reset(&p->frame_time);
+
+    if (want_vsync && renderer) {
+        if (SDL_SetRenderVSync(renderer, 1)) {
+            p->vsync = true;
+            SDL_Log("VSync on; frame pacing left to the renderer.");
+        } else {
+            SDL_Log("VSync unavailable (%s); using the frame cap.", SDL_GetError());
+        }
+    }
+}
+
+void FramePacer_Wait(FramePacer* p, uint64_t frame_start) {
+    if (!p) return;
+
+    if (p->last_frame_start != 0) {
+        Histogram_Record(&p->frame_time, frame_start - p->last_frame_start);
+    }
+    p->last_frame_start = frame_start;
+
+    if (p->vsync || p->frame_ns == 0) return;
+
+    const uint64_t deadline = frame_start + p->frame_ns;
+    uint64_t now = SDL_GetTicksNS();
+    if (now >= deadline) return;
+
+    // Coarse sleep, leaving the spin window for the scheduler's wake-up slop.
+    if (deadline - now > p->spin_ns) {
+        SDL_DelayNS(deadline - now - p->spin_ns);
+    }
+
+    while (SDL_GetTicksNS() < deadline) {
+        SDL_CPUPauseInstruction();
+    }
+}
@@ -0,0 +1,88 @@
+#include "histogram.h"
+#include <SDL3/SDL.h>
+#include <string.h>
+
+
+/*
+ * histogram.c
+ * Log-linear bucket math for Histogram.
+ *
+ * A value v >= 32 with top bit e lands in bucket (e - 5) * 32 + (v >> (e - 5)):
+ * the shifted value keeps the top 6 bits, 32..63, so consecutive powers of two
+ * take consecutive runs of 32 buckets.
+ */
+
+
+#define SUB_COUNT (1 << HISTOGRAM_SUB_BITS)
+
+static int top_bit(uint64_t v) {
+    Uint32 hi = (Uint32)(v >> 32);
+    if (hi) return 32 + SDL_MostSignificantBitIndex32(hi);
+    return SDL_MostSignificantBitIndex32((Uint32)v);
+}
+
+static int bucket_of(uint64_t v) {
+    if (v < SUB_COUNT) return (int)v;
+    int e = top_bit(v);
+    if (e >= HISTOGRAM_MAX_BITS) return HISTOGRAM_BUCKETS - 1;
+    int shift = e - HISTOGRAM_SUB_BITS;
+    return (shift << HISTOGRAM_SUB_BITS) + (int)(v >> shift);
+}
+
+// Largest value that maps to bucket i.
+static uint64_t bucket_top(int i) {
+    if (i < SUB_COUNT) return (uint64_t)i;
+    int shift = (i >> HISTOGRAM_SUB_BITS) - 1;
+    uint64_t m = (uint64_t)(i - (shift << HISTOGRAM_SUB_BITS));
+    return ((m + 1) << shift) - 1;
+}
+
+void Histogram_Reset(Histogram* h) {
+    if (!h) return;
+    memset(h, 0, sizeof(*h));
+}
+
+void Histogram_Record(Histogram* h, uint64_t ns) {
+    if (!h) return;
+    h->counts[bucket_of(ns)]++;
+    if (h->count == 0 || ns < h->min_ns) h->min_ns = ns;
+    if (ns > h->max_ns) h->max_ns = ns;
+    h->count++;
+    h->sum_ns += ns;
+}
+
+void Histogram_Merge(Histogram* dst, const Histogram* src) {
+    if (!dst || !src || src->count == 0) return;
+    for (int i = 0; i < HISTOGRAM_BUCKETS; i++) {
+        dst->counts[i] += src->counts[i];
+    }
+    if (dst->count == 0 || src->min_ns < dst->min_ns) dst->min_ns = src->min_ns;
+    if (src->max_ns > dst->max_ns) dst->max_ns = src->max_ns;
+    dst->count += src->count;
+    dst->sum_ns += src->sum_ns;
+}
+
+uint64_t Histogram_Percentile(const Histogram* h, double p) {
+    if (!h || h->count == 0) return 0;
+    if (p <= 0.0) return h->min_ns;
+    if (p >= 1.0) return h->max_ns;
+
+    uint64_t want = (uint64_t)(p * (double)h->count);
+    if ((double)want < p * (double)h->count) want++;
+    if (want == 0) want = 1;
+
+    uint64_t seen = 0;
+    for (int i = 0; i < HISTOGRAM_BUCKETS; i++) {
+        seen += h->counts[i];
+        if (seen >= want) {
+            uint64_t top = bucket_top(i);
+            return (top < h->max_ns) ? top : h->max_ns;
+        }
+    }
+    return h->max_ns;
+}
+
+double Histogram_MeanNs(const Histogram* h) {
+    if (!h || h->count == 0) return 0.0;
+    return (double)h->sum_ns / (double)h->count;
+}
@@ -17,17 +17,21 @@
 #include "app.h"
 #include "apple.h"
 #include "bot.h"
+#include "cycle_file.h"
 #include "death_fx.h"
 #include "events.h"
 #include "fps.h"
+#include "frame_pacer.h"
 #include "render.h"
+#include "sim_thread.h"
 #include "snake.h"
 #include "snake_draw.h"
 
 /*
  * main.c
- * Game loop: fixed-tick simulation + optional interpolated rendering.
- * Tick rate ramps with score; render rate is capped separately.
+ * Game loop: the fixed-tick simulation runs on its own thread (sim_thread.h);
+ * this thread polls input and renders the latest snapshot, optionally
+ * interpolated. Tick rate ramps with score; render rate is capped separately.
  */
 
 #define GRID_W 40
@@ -35,10 +39,6 @@
 #define BASE_CELL_SIZE 20
 #define MAX_WINDOW_DIM 1080
 
-#define BASE_TICK_HZ 7
-#define RAMP_EVERY 3
-#define MAX_TICK_HZ 20
-
 #define RENDER_CAP_HZ 240
 
 // Above this TPS, disable "snappy head" and interpolate the whole snake
@@ -55,14 +55,6 @@ static inline double clamp01(double x) {
   return (x < 0.0) ? 0.0 : (x > 1.0) ? 1.0 : x;
 }
 
-static inline int clampi(int v, int lo, int hi) {
-  if (v < lo)
-    return lo;
-  if (v > hi)
-    return hi;
-  return v;
-}
-
 static int cell_size_for_grid(int grid_w, int grid_h) {
   int max_dim = (grid_w > grid_h) ? grid_w : grid_h;
   int cell = BASE_CELL_SIZE;
@@ -112,43 +104,6 @@ static MIX_Audio *load_bgm(MIX_Mixer *mixer) {
   return audio;
 }
 
-static int tick_hz_for_score(int score) {
-  int hz = BASE_TICK_HZ + (score / RAMP_EVERY);
-  return clampi(hz, 1, MAX_TICK_HZ);
-}
-
-static bool snake_hit_self(const Snake *s) {
-  if (!s || s->len <= 1)
-    return false;
-  IVec2 head = s->seg[0];
-  for (int i = 1; i < s->len; i++) {
-    if (s->seg[i].x == head.x && s->seg[i].y == head.y) {
-      return true;
-    }
-  }
-  return false;
-}
-
-static void Snake_ForceWinFill(Snake *s) {
-  if (!s)
-    return;
-  while (s->grow > 0 && s->len < s->max_len) {
-    IVec2 tail_prev = s->prev[s->len - 1];
-    s->seg[s->len] = tail_prev;
-    s->prev[s->len] = tail_prev;
-    s->len += 1;
-    s->grow -= 1;
-  }
-}
-
-static void Snake_SyncPrevToSeg(Snake *s) {
-  if (!s || !s->prev || !s->seg)
-    return;
-  for (int i = 0; i < s->len; i++) {
-    s->prev[i] = s->seg[i];
-  }
-}
-
 static const char *log_priority_name(SDL_LogPriority priority) {
   switch (priority) {
     case SDL_LOG_PRIORITY_VERBOSE:
@@ -278,215 +233,27 @@ static void Log_CloseFile(void) {
   g_log_file = NULL;
 }
 
-static void Game_Reset(Snake *snake, Apple *apple, int *score, int *tick_hz,
-                       uint64_t *tick_ns, uint64_t *acc, bool *game_over,
-                       bool *you_win, bool *interp, bool interp_setting,
-                       DeathFx *death_fx, const App *app, bool bot_enabled,
-                       int bot_tps) {
-  Snake_Destroy(snake);
-
-  Dir start_dir = (Dir)SDL_rand(4);
-  Snake_Init(snake, app->grid_w, app->grid_h, app->grid_w * app->grid_h,
-             start_dir);
-
-  *score = snake->len - 1;
-  if (*score < 0)
-    *score = 0;
-
-  Apple_Init(apple, snake);
-
-  *tick_hz =
-      (bot_enabled && bot_tps > 0) ? bot_tps : tick_hz_for_score(*score);
-  *tick_ns = ns_from_hz(*tick_hz);
-  *acc = 0;
-
-  *game_over = false;
-  *you_win = false;
-
-  // Preserve the player's interpolation toggle across rounds.
-  // (A reset should restart gameplay, not silently change their render
-  // preference.)
-  *interp = interp_setting;
-
-  DeathFx_Init(death_fx);
-}
-
-static void SetEndTitle(SDL_Window *window, bool you_win, int score) {
-  if (!window)
-    return;
-  char title[256];
-  if (you_win) {
-    snprintf(title, sizeof(title),
-             "snake-sdl | YOU WIN! - Continue? (L) | Score: %d", score);
-  } else {
-    snprintf(title, sizeof(title),
-             "snake-sdl | GAME OVER - Continue? (L) | Score: %d", score);
-  }
-  SDL_SetWindowTitle(window, title);
-}
-
 static bool arg_eq(const char *a, const char *b) {
   return a && b && strcmp(a, b) == 0;
 }
 
-static bool parse_preset_name(const char *name, Preset *out) {
-  if (!name || !out)
-    return false;
-  if (strcmp(name, "safe") == 0) {
-    *out = PRESET_SAFE;
-    return true;
-  }
-  if (strcmp(name, "aggressive") == 0) {
-    *out = PRESET_AGGRESSIVE;
-    return true;
-  }
-  if (strcmp(name, "greedy") == 0 || strcmp(name, "greedy-apple") == 0 ||
-      strcmp(name, "greedy_apple") == 0) {
-    *out = PRESET_GREEDY_APPLE;
-    return true;
-  }
-  if (strcmp(name, "chaotic") == 0) {
-    *out = PRESET_CHAOTIC;
-    return true;
-  }
-  return false;
-}
-
-typedef struct CycleMeta {
-  int grid_w;
-  int grid_h;
-  int window_w;
-  int window_h;
-  unsigned int seed;
-} CycleMeta;
-
-static bool parse_cycle_meta(const char *path, CycleMeta *out, char *err,
-                             int err_len) {
-  if (!path || !out) {
-    snprintf(err, (size_t)err_len, "invalid cycle path");
-    return false;
-  }
-
-  FILE *f = fopen(path, "rb");
-  if (!f) {
-    snprintf(err, (size_t)err_len, "failed to open cycle file");
-    return false;
-  }
-
-  fseek(f, 0, SEEK_END);
-  long sz = ftell(f);
-  fseek(f, 0, SEEK_SET);
-  if (sz <= 0) {
-    fclose(f);
-    snprintf(err, (size_t)err_len, "cycle file is empty");
-    return false;
-  }
-
-  char *buf = (char *)malloc((size_t)sz + 1);
-  if (!buf) {
-    fclose(f);
-    snprintf(err, (size_t)err_len, "out of memory reading cycle file");
-    return false;
-  }
-  size_t got = fread(buf, 1, (size_t)sz, f);
-  fclose(f);
-  buf[got] = '\0';
-
-  int grid_w = -1;
-  int grid_h = -1;
-  int window_w = -1;
-  int window_h = -1;
-  unsigned int seed = 0;
-
-  char *p = buf;
-  while (*p == '\r' || *p == '\n' || *p == ' ' || *p == '\t')
-    p++;
-  char *line_end = strpbrk(p, "\r\n");
-  if (!line_end) {
-    free(buf);
-    snprintf(err, (size_t)err_len, "cycle file missing header");
-    return false;
-  }
-  *line_end = '\0';
-  if (strcmp(p, "SNAKECYCLE 1") != 0) {
-    free(buf);
-    snprintf(err, (size_t)err_len, "cycle file header invalid");
-    return false;
-  }
-
-  p = line_end + 1;
-  while (*p) {
-    while (*p == '\r' || *p == '\n')
-      p++;
-    if (!*p)
-      break;
-
-    char *e = strpbrk(p, "\r\n");
-    if (e)
-      *e = '\0';
-
-    char *s = p;
-    while (*s == ' ' || *s == '\t')
-      s++;
-
-    if (*s == '\0' || *s == '#') {
-      // skip
-    } else if (strcmp(s, "DATA") == 0) {
-      break;
-    } else {
-      char *eq = strchr(s, '=');
-      if (eq) {
-        *eq = '\0';
-        char *key = s;
-        char *val = eq + 1;
-        while (*val == ' ' || *val == '\t')
-          val++;
-        int iv = atoi(val);
-        if (strcmp(key, "width") == 0)
-          grid_w = iv;
-        else if (strcmp(key, "height") == 0)
-          grid_h = iv;
-        else if (strcmp(key, "window_w") == 0)
-          window_w = iv;
-        else if (strcmp(key, "window_h") == 0)
-          window_h = iv;
-        else if (strcmp(key, "seed") == 0)
-          seed = (unsigned int)iv;
-      }
-    }
-
-    if (!e)
-      break;
-    p = e + 1;
-  }
-
-  free(buf);
-
-  if (grid_w <= 0 || grid_h <= 0) {
-    snprintf(err, (size_t)err_len, "cycle metadata missing dimensions");
-    return false;
-  }
-  if (grid_w < 2 || grid_h < 2) {
+// Game-side rules on top of what CycleFile_Load already checks.
+static bool check_cycle_meta(const CycleFileMeta *m, char *err, int err_len) {
+  if (m->width < 2 || m->height < 2) {
     snprintf(err, (size_t)err_len, "grid width/height must be >= 2");
     return false;
   }
-  if (window_w > 0 && window_h > 0) {
-    if ((window_w % grid_w) != 0 || (window_h % grid_h) != 0) {
+  if (m->window_w > 0 && m->window_h > 0) {
+    if ((m->window_w % m->width) != 0 || (m->window_h % m->height) != 0) {
       snprintf(err, (size_t)err_len,
                "window size must be divisible by grid size");
       return false;
     }
   }
-  if (seed == 0) {
+  if (m->seed == 0) {
     snprintf(err, (size_t)err_len, "cycle seed is required");
     return false;
   }
-
-  out->grid_w = grid_w;
-  out->grid_h = grid_h;
-  out->window_w = window_w;
-  out->window_h = window_h;
-  out->seed = seed;
   return true;
 }
 
@@ -497,6 +264,7 @@ int main(int argc, char **argv) {
   bool bot_enabled = false;
   bool bot_gui = false;
   int bot_tps = 0;
+  bool bot_max_speed = false;
   const char *bot_cycle_path = NULL;
   BotTuning bot_tuning = {0};
   apply_preset(PRESET_SAFE, &bot_tuning);
@@ -506,21 +274,38 @@ int main(int argc, char **argv) {
   unsigned int cli_seed = 0;
   bool cli_seed_set = false;
   bool bgm_enabled = true;
+  bool vsync = false;
 
   // CLI:
   //   --bot                 enable bot mode
   //   --bot-cycle <file>    optional .cycle container file (refused if not
   //   .cycle)
+  //   --bot-tps <n|max>     bot tick rate (7..7000), or max speed
   //   --no-bgm              disable background music
+  //   --vsync               pace frames with renderer VSync when available
   for (int i = 1; i < argc; i++) {
-    if (arg_eq(argv[i], "--bot")) {
+    int tuning_used = parse_tuning_arg(argc, argv, i, &bot_tuning);
+    if (tuning_used < 0) {
+      SDL_Log("Invalid value for %s: %s", argv[i], argv[i + 1]);
+      return 1;
+    }
+    if (tuning_used > 0) {
+      i += tuning_used;
+    } else if (arg_eq(argv[i], "--bot")) {
       bot_enabled = true;
     } else if (arg_eq(argv[i], "--bot-gui")) {
       bot_gui = true;
     } else if (arg_eq(argv[i], "--bot-cycle") && i + 1 < argc) {
       bot_cycle_path = argv[i + 1];
       i++;
+    } else if (arg_eq(argv[i], "--bot-tps") && i + 1 < argc &&
+               arg_eq(argv[i + 1], "max")) {
+      // As many ticks as the sim thread can run (see sim_thread.h).
+      bot_max_speed = true;
+      bot_tps = 0;
+      i++;
     } else if (arg_eq(argv[i], "--bot-tps") && i + 1 < argc) {
+      bot_max_speed = false;
       bot_tps = atoi(argv[i + 1]);
       if (bot_tps > 7000) {
         SDL_Log("Bot TPS cannot exceed 7000 (requested %d).", bot_tps);
@@ -531,38 +316,6 @@ int main(int argc, char **argv) {
         bot_tps = -1;
       }
       i++;
-    } else if (arg_eq(argv[i], "--bot-preset") && i + 1 < argc) {
-      Preset p;
-      if (!parse_preset_name(argv[i + 1], &p)) {
-        SDL_Log("Unknown preset: %s", argv[i + 1]);
-        return 1;
-      }
-      apply_preset(p, &bot_tuning);
-      i++;
-    } else if (arg_eq(argv[i], "--bot-k-progress") && i + 1 < argc) {
-      bot_tuning.k_progress = strtod(argv[i + 1], NULL);
-      i++;
-    } else if (arg_eq(argv[i], "--bot-k-away") && i + 1 < argc) {
-      bot_tuning.k_away = strtod(argv[i + 1], NULL);
-      i++;
-    } else if (arg_eq(argv[i], "--bot-k-skip") && i + 1 < argc) {
-      bot_tuning.k_skip = strtod(argv[i + 1], NULL);
-      i++;
-    } else if (arg_eq(argv[i], "--bot-k-slack") && i + 1 < argc) {
-      bot_tuning.k_slack = strtod(argv[i + 1], NULL);
-      i++;
-    } else if (arg_eq(argv[i], "--bot-k-loop") && i + 1 < argc) {
-      bot_tuning.k_loop = strtod(argv[i + 1], NULL);
-      i++;
-    } else if (arg_eq(argv[i], "--bot-loop-window") && i + 1 < argc) {
-      bot_tuning.loop_window = atoi(argv[i + 1]);
-      i++;
-    } else if (arg_eq(argv[i], "--bot-aggression-scale") && i + 1 < argc) {
-      bot_tuning.aggression_scale = strtod(argv[i + 1], NULL);
-      i++;
-    } else if (arg_eq(argv[i], "--bot-max-skip-cap") && i + 1 < argc) {
-      bot_tuning.max_skip_cap = atoi(argv[i + 1]);
-      i++;
     } else if (arg_eq(argv[i], "--grid-w") && i + 1 < argc) {
       cli_grid_w = atoi(argv[i + 1]);
       i++;
@@ -575,10 +328,14 @@ int main(int argc, char **argv) {
       i++;
     } else if (arg_eq(argv[i], "--no-bgm")) {
       bgm_enabled = false;
+    } else if (arg_eq(argv[i], "--vsync")) {
+      vsync = true;
     }
   }
 
-  CycleMeta meta = {0};
+  // The cycle file is read and decoded once, here; Bot_InitFromCycle takes the
+  // result below.
+  CycleFile cycle = {0};
   if (bot_enabled) {
     if (!bot_gui) {
       SDL_Log("Bot mode requires GUI launch (--bot-gui).");
@@ -588,14 +345,16 @@ int main(int argc, char **argv) {
       SDL_Log("Bot mode requires --bot-cycle.");
       return 1;
     }
-    if (bot_tps <= 0) {
-      SDL_Log("Bot mode requires a valid --bot-tps (7..7000).");
+    if (bot_tps <= 0 && !bot_max_speed) {
+      SDL_Log("Bot mode requires a valid --bot-tps (7..7000 or max).");
       return 1;
     }
-    char meta_err[256];
-    if (!parse_cycle_meta(bot_cycle_path, &meta, meta_err,
-                          (int)sizeof(meta_err))) {
-      SDL_Log("Bot cycle metadata invalid: %s", meta_err);
+    char cycle_err[256];
+    if (!CycleFile_Load(&cycle, bot_cycle_path, cycle_err,
+                        (int)sizeof(cycle_err)) ||
+        !check_cycle_meta(&cycle.meta, cycle_err, (int)sizeof(cycle_err))) {
+      SDL_Log("Bot cycle file invalid: %s", cycle_err);
+      CycleFile_Free(&cycle);
       return 1;
     }
   }
@@ -603,14 +362,15 @@ int main(int argc, char **argv) {
   int init_grid_w = GRID_W;
   int init_grid_h = GRID_H;
   if (bot_enabled) {
-    init_grid_w = meta.grid_w;
-    init_grid_h = meta.grid_h;
+    init_grid_w = cycle.meta.width;
+    init_grid_h = cycle.meta.height;
   } else {
     init_grid_w = cli_grid_w;
     init_grid_h = cli_grid_h;
   }
   if (init_grid_w < 2 || init_grid_h < 2) {
     SDL_Log("Grid width/height must be >= 2.");
+    CycleFile_Free(&cycle);
     return 1;
   }
   int init_window_w = 0;
@@ -621,6 +381,7 @@ int main(int argc, char **argv) {
 
   App app = {0};
   if (!App_Init(&app, init_window_w, init_window_h, init_grid_w, init_grid_h)) {
+    CycleFile_Free(&cycle);
     return 1;
   }
   Log_AttachToSDL();
@@ -662,11 +423,12 @@ int main(int argc, char **argv) {
   }
 
   if (bot_enabled) {
-    SDL_srand((Uint64)meta.seed);
+    SDL_srand((Uint64)cycle.meta.seed);
   } else if (cli_seed_set) {
     // Optional deterministic seed for human-mode launches.
     if (cli_seed == 0) {
       SDL_Log("Seed must be a positive integer.");
+      CycleFile_Free(&cycle);
       App_Shutdown(&app);
       return 1;
     }
@@ -684,71 +446,60 @@ int main(int argc, char **argv) {
   bool interp_setting = true;
   bool interp = interp_setting;
 
-  Dir start_dir = (Dir)SDL_rand(4);
-
-  Snake snake;
-  if (!Snake_Init(&snake, app.grid_w, app.grid_h, app.grid_w * app.grid_h,
-                  start_dir)) {
-    App_Shutdown(&app);
-    return 1;
-  }
-
   // Bot is embedded in-game, but only initialized/used when enabled.
   if (bot_enabled) {
-    bot_ready = Bot_Init(&bot, app.grid_w, app.grid_h);
+    bot_ready = Bot_InitFromCycle(&bot, &cycle);
+    CycleFile_Free(&cycle);
     if (!bot_ready) {
-      SDL_Log("Bot_Init failed.");
+      SDL_Log("Bot cycle load failed (%s).", bot_cycle_path);
       App_Shutdown(&app);
       return 1;
     }
-    if (bot_cycle_path) {
-      if (!Bot_LoadCycleFromFile(&bot, bot_cycle_path)) {
-        SDL_Log("Bot cycle load failed (%s).", bot_cycle_path);
-        Bot_Destroy(&bot);
-        App_Shutdown(&app);
-        return 1;
-      }
-    }
     Bot_SetTuning(&bot, &bot_tuning);
+    // Two clock reads are a sizeable share of a sub-microsecond tick, so
+    // max speed only times decisions when a tick budget asks for it.
+    bot.time_decisions = !bot_max_speed;
+  }
+
+  // Snake, apple and bot live on the sim thread from SimThread_Start until
+  // SimThread_Stop; this thread only reads the snapshots it publishes.
+  SimThread sim;
+  if (!SimThread_Init(&sim, app.grid_w, app.grid_h, bot_ready ? &bot : NULL,
+                      bot_enabled ? bot_tps : 0)) {
+    if (bot_ready)
+      Bot_Destroy(&bot);
+    CycleFile_Free(&cycle);
+    App_Shutdown(&app);
+    return 1;
   }
 
+  const uint64_t frame_ns = ns_from_hz(RENDER_CAP_HZ);
+  // Tick batches get one render frame's worth of time.
+  sim.batch_budget_ns = frame_ns;
+
 #if DEBUG_START_LONG
-  debug_make_snake_long(&snake, DEBUG_START_LEN);
+  debug_make_snake_long(&sim.snake, DEBUG_START_LEN);
 #endif
 
-  int score = snake.len - 1;
-  if (score < 0)
-    score = 0;
-
-  const int max_score = snake.max_len - 1;
-
-  Apple apple;
-  Apple_Init(&apple, &snake);
-
-  const uint64_t frame_ns = ns_from_hz(RENDER_CAP_HZ);
-
-  int tick_hz =
-      (bot_enabled && bot_tps > 0) ? bot_tps : tick_hz_for_score(score);
-  uint64_t tick_ns = ns_from_hz(tick_hz);
-  if (bot_enabled && bot_tps >= BOT_INTERP_CUTOFF_TPS) {
+  const bool bot_fast =
+      bot_enabled && (bot_max_speed || bot_tps >= BOT_INTERP_CUTOFF_TPS);
+  if (bot_fast) {
     interp_setting = false;
     interp = false;
   }
 
-  uint64_t last = SDL_GetTicksNS();
-  uint64_t acc = 0;
-
-  bool game_over = false;
-  bool you_win = false;
-
   float freeze_alpha = 1.0f;
 
   DeathFx death_fx;
   DeathFx_Init(&death_fx);
+  uint32_t shown_game = sim.game;
 
   FpsCounter fps;
   Fps_Init(&fps);
 
+  FramePacer pacer;
+  FramePacer_Init(&pacer, app.renderer, frame_ns, vsync);
+
   SnakeDrawStyle style_green = {.snap_head = true,
                                 .draw_bridges = true,
                                 .head_r = 0,
@@ -767,36 +518,46 @@ int main(int argc, char **argv) {
                                .body_g = 120,
                                .body_b = 220};
 
+  if (!SimThread_Start(&sim)) {
+    SimThread_Destroy(&sim);
+    if (bot_ready)
+      Bot_Destroy(&bot);
+    App_Shutdown(&app);
+    return 1;
+  }
+
+  const uint64_t run_start = SDL_GetTicksNS();
   while (running) {
     uint64_t frame_start = SDL_GetTicksNS();
 
-    uint64_t now = frame_start;
-    uint64_t dt = now - last;
-    last = now;
-
-    if (dt > 250000000ull)
-      dt = 250000000ull;
-    acc += dt;
-
     EventsFrame ev = {0};
     Events_Poll(&ev);
 
     if (ev.quit)
       break;
 
-    // Continue after win or game over
-    if ((game_over || you_win) && ev.continue_game) {
-      Game_Reset(&snake, &apple, &score, &tick_hz, &tick_ns, &acc, &game_over,
-                 &you_win, &interp, interp_setting, &death_fx, &app,
-                 bot_enabled, bot_tps);
-      if (bot_enabled && bot_ready) {
-        bot.cycle_pos = -1;
-      }
-      continue;
+    if (ev.render_reset)
+      Render_InvalidateGridCache(&app);
+
+    const SimSnapshot *snap = SimThread_Latest(&sim);
+    const bool game_over = snap->game_over;
+    const bool you_win = snap->you_win;
+
+    // A new game: restart the death effect and restore the player's
+    // interpolation toggle (a reset restarts gameplay, not render settings).
+    if (snap->game != shown_game) {
+      shown_game = snap->game;
+      DeathFx_Init(&death_fx);
+      interp = interp_setting;
     }
 
+    // Continue after win or game over
+    if ((game_over || you_win) && ev.continue_game)
+      SimThread_RequestContinue(&sim);
+
     // Head snapping threshold (render behavior only)
-    const bool full_interp = (tick_hz >= FULL_INTERP_TPS || snake.len == 1);
+    const bool full_interp =
+        (snap->tick_hz >= FULL_INTERP_TPS || snap->snake.len == 1);
     style_green.snap_head = !full_interp;
     style_blue.snap_head = !full_interp;
 
@@ -808,7 +569,7 @@ int main(int argc, char **argv) {
         // Keep both the live render flag and the "remembered" preference in
         // sync. We don't want end states (win/death) or resets to implicitly
         // flip it.
-        if (!(bot_enabled && bot_tps >= BOT_INTERP_CUTOFF_TPS)) {
+        if (!bot_fast) {
           interp_setting = !interp_setting;
           interp = interp_setting;
         }
@@ -816,120 +577,103 @@ int main(int argc, char **argv) {
 
       if (!bot_enabled) {
         for (int i = 0; i < ev.dir_count; i++) {
-          Snake_QueueDir(&snake, ev.dirs[i]);
-        }
-      }
-
-      // Difficulty ramp: adjust tick rate based on current score.
-      if (!bot_enabled) {
-        int desired_hz = tick_hz_for_score(score);
-        if (desired_hz != tick_hz) {
-          uint64_t old_tick_ns = tick_ns;
-
-          tick_hz = desired_hz;
-          tick_ns = ns_from_hz(tick_hz);
-
-          // Rescale acc so the interpolation fraction stays consistent when
-          // tick_ns changes.
-          if (old_tick_ns > 0 && tick_ns > 0) {
-            double frac = (double)acc / (double)old_tick_ns;
-            acc = (uint64_t)(frac * (double)tick_ns);
-          }
-          if (acc > tick_ns * 4)
-            acc = tick_ns * 4;
+          SimThread_QueueDir(&sim, ev.dirs[i]);
         }
       }
+    }
 
-      // Fixed-timestep update: consume whole ticks from the accumulator.
-      while (acc >= tick_ns) {
-        if (bot_enabled && bot_ready) {
-          Bot_OnTick(&bot, &snake, &apple);
-        }
-        Snake_Tick(&snake);
-
-        if (Apple_TryEatAndRespawn(&apple, &snake)) {
-          score += 1;
-
-          if (score >= max_score) {
-            Snake_ForceWinFill(&snake);
-            Snake_SyncPrevToSeg(&snake);
-            you_win = true;
-
-            // Freeze pose + mode on win so the final frame stays visually
-            // stable.
-            freeze_alpha = 1.0f;
-
-            acc = 0;
-            break;
-          }
-        }
-
-        if (snake_hit_self(&snake)) {
-          game_over = true;
-
-          float death_alpha =
-              interp ? (float)clamp01((double)acc / (double)tick_ns) : 1.0f;
-
-          // Start death disintegration using the current interpolation fraction
-          // as the snapshot pose.
-          DeathFx_Start(&death_fx, interp, death_alpha, SDL_GetTicksNS());
-
-          acc = 0;
-          break;
-        }
+    // Fraction of the way from this snapshot's tick to the next one.
+    const uint64_t now = SDL_GetTicksNS();
+    double since_tick = (double)(int64_t)(now - snap->tick_time_ns);
+    float alpha = (interp && snap->tick_ns > 0)
+                      ? (float)clamp01(since_tick / (double)snap->tick_ns)
+                      : 1.0f;
 
-        Fps_OnTick(&fps);
-        acc -= tick_ns;
-      }
-    }
+    // Start the death disintegration from the pose on screen right now.
+    if (game_over && !death_fx.active)
+      DeathFx_Start(&death_fx, interp, alpha, now);
 
     // -------- RENDER --------
+    const uint64_t render_start = SDL_GetTicksNS();
+    App_BeginFrame(&app);
     Render_Clear(app.renderer);
 
     if (you_win) {
       if (show_grid) {
-        Render_GridLinesEx(&app, 40, 40, 40, 120);
+        Render_GridLinesDimmed(&app);
       }
-      SnakeDraw_Render(&app, &snake, freeze_alpha, style_blue);
+      SnakeDraw_Render(&app, &snap->snake, freeze_alpha, style_blue);
     } else if (game_over) {
       if (show_grid) {
-        Render_GridLinesEx(&app, 40, 40, 40, 120);
+        Render_GridLinesDimmed(&app);
       }
-      DeathFx_RenderAndAdvance(&death_fx, &app, &snake, SDL_GetTicksNS());
+      DeathFx_RenderAndAdvance(&death_fx, &app, &snap->snake, SDL_GetTicksNS());
     } else {
       if (show_grid) {
         Render_GridLines(&app);
       }
 
-      Render_CellFilled(&app, apple.pos, 220, 40, 40);
+      Render_CellFilled(&app, snap->apple.pos, 220, 40, 40);
 
-      float alpha =
-          interp ? (float)clamp01((double)acc / (double)tick_ns) : 1.0f;
-
-      SnakeDraw_Render(&app, &snake, alpha, style_green);
+      SnakeDraw_Render(&app, &snap->snake, alpha, style_green);
     }
 
+    const uint64_t present_start = SDL_GetTicksNS();
+    Fps_Record(&fps, FPS_HIST_RENDER, present_start - render_start);
     Render_Present(app.renderer);
+    Fps_Record(&fps, FPS_HIST_PRESENT, SDL_GetTicksNS() - present_start);
 
     Fps_OnFrame(&fps);
+    Fps_AddTicks(&fps, SimThread_TakeTicks(&sim));
 
     // Title: end states are authoritative and bypass FPS text
     if (game_over || you_win) {
-      SetEndTitle(app.window, you_win, score);
+      Fps_SetEndTitle(&fps, app.window, you_win, snap->score);
     } else {
-      Fps_UpdateWindowTitle(&fps, app.window, interp, score, game_over,
+      Fps_UpdateWindowTitle(&fps, app.window, interp, snap->score, game_over,
                             you_win);
     }
 
-    if (frame_ns > 0) {
-      uint64_t elapsed = SDL_GetTicksNS() - frame_start;
-      if (elapsed < frame_ns) {
-        SDL_DelayNS(frame_ns - elapsed);
-      }
-    }
+    FramePacer_Wait(&pacer, frame_start);
+  }
+
+  SimThread_Stop(&sim);
+
+  // The sim thread is joined, so its histograms can be read now.
+  Fps_MergeHistogram(&fps, FPS_HIST_FRAME, &pacer.frame_time);
+  Fps_MergeHistogram(&fps, FPS_HIST_SIM, &sim.stats.tick_time);
+  if (bot_ready)
+    Fps_MergeHistogram(&fps, FPS_HIST_BOT, &bot.decide_time);
+  SDL_Log("Timing histograms (frame pacing: %s):",
+          pacer.vsync ? "vsync" : "frame cap");
+  Fps_LogHistograms(&fps);
+
+  const double run_secs = (double)(SDL_GetTicksNS() - run_start) / 1e9;
+  SDL_Log("Window title: %llu updates (%.2f/s), %llu unchanged calls skipped.",
+          (unsigned long long)fps.title_updates,
+          run_secs > 0.0 ? (double)fps.title_updates / run_secs : 0.0,
+          (unsigned long long)fps.title_skipped);
+
+  const SimTickStats *ts = &sim.stats;
+  if (ts->ticks > 0) {
+    SDL_Log("Sim: %llu ticks in %llu batches (max %llu per batch); tick cost "
+            "avg %.2f us, max %.2f us; %llu deferred, %llu dropped.",
+            (unsigned long long)ts->ticks, (unsigned long long)ts->batches,
+            (unsigned long long)ts->max_batch,
+            (double)ts->tick_ns_total / (double)ts->ticks / 1000.0,
+            (double)ts->tick_ns_max / 1000.0,
+            (unsigned long long)ts->deferred, (unsigned long long)ts->dropped);
   }
 
   if (bot_ready) {
+    if (bot.tuning.tick_budget_us > 0 && bot.n_decisions > 0) {
+      SDL_Log("Bot decision: avg %.2f us, max %.2f us (budget %d us); "
+              "lookahead on %llu ticks, budget exhausted on %llu.",
+              (double)bot.decide_ns_total / (double)bot.n_decisions / 1000.0,
+              (double)bot.decide_ns_max / 1000.0, bot.tuning.tick_budget_us,
+              (unsigned long long)bot.n_lookahead,
+              (unsigned long long)bot.n_budget_exhausted);
+    }
     Bot_Destroy(&bot);
   }
 
@@ -946,7 +690,7 @@ int main(int argc, char **argv) {
       MIX_Quit();
   }
 
-  Snake_Destroy(&snake);
+  SimThread_Destroy(&sim);
   App_Shutdown(&app);
   Log_CloseFile();
   return 0;
@@ -9,9 +9,20 @@
  *
  * Note: Render_QuadCenteredPx uses SDL_RenderGeometry so we can rotate quads
  * without setting up textures or a separate math layer.
+ *
+ * Grid lines are rendered once into target textures held by App and blitted
+ * each frame; Render_GridLinesEx stays as the direct path (and the fallback
+ * when target textures are unsupported).
  */
 
 
+#define GRID_R 40
+#define GRID_G 40
+#define GRID_B 40
+#define GRID_A 255
+#define GRID_DIM_A 120
+
+
 void Render_Clear(SDL_Renderer* r) {
     SDL_SetRenderDrawColor(r, 20, 20, 20, 255);
     SDL_RenderClear(r);
@@ -88,10 +99,11 @@ void Render_QuadCenteredPx(const App* app, float cx, float cy, float w, float h,
     SDL_Vertex v[4];
     for (int i = 0; i < 4; i++) {
         v[i].position = p[i];
-        v[i].color.r = r;
-        v[i].color.g = g;
-        v[i].color.b = b;
-        v[i].color.a = a;
+        // SDL3 vertex colors are normalized floats.
+        v[i].color.r = (float)r / 255.0f;
+        v[i].color.g = (float)g / 255.0f;
+        v[i].color.b = (float)b / 255.0f;
+        v[i].color.a = (float)a / 255.0f;
         v[i].tex_coord.x = 0.0f;
         v[i].tex_coord.y = 0.0f;
     }
@@ -100,10 +112,9 @@ void Render_QuadCenteredPx(const App* app, float cx, float cy, float w, float h,
     SDL_RenderGeometry(app->renderer, NULL, v, 4, idx, 6);
 }
 
-void Render_GridLinesEx(const App* app, uint8_t r, uint8_t g, uint8_t b, uint8_t a) {
-    if (!app || !app->renderer) return;
-
-    SDL_SetRenderDrawBlendMode(app->renderer, SDL_BLENDMODE_BLEND);
+static void draw_grid_lines(const App* app, SDL_BlendMode blend,
+                            uint8_t r, uint8_t g, uint8_t b, uint8_t a) {
+    SDL_SetRenderDrawBlendMode(app->renderer, blend);
     SDL_SetRenderDrawColor(app->renderer, r, g, b, a);
 
     for (int x = 0; x <= app->grid_w; x++) {
@@ -117,7 +128,92 @@ void Render_GridLinesEx(const App* app, uint8_t r, uint8_t g, uint8_t b, uint8_t
     }
 }
 
-void Render_GridLines(const App* app) {
+void Render_GridLinesEx(const App* app, uint8_t r, uint8_t g, uint8_t b, uint8_t a) {
+    if (!app || !app->renderer) return;
+    draw_grid_lines(app, SDL_BLENDMODE_BLEND, r, g, b, a);
+}
+
+void Render_InvalidateGridCache(App* app) {
+    if (!app) return;
+    if (app->grid_tex) SDL_DestroyTexture(app->grid_tex);
+    if (app->grid_tex_dim) SDL_DestroyTexture(app->grid_tex_dim);
+    app->grid_tex = NULL;
+    app->grid_tex_dim = NULL;
+    app->grid_tex_failed = false;
+}
+
+// Renders the grid into a transparent target texture. Lines are written with
+// blending off so the texel alpha is exactly `a`; blitting with BLEND then
+// matches drawing the lines straight onto the frame.
+static SDL_Texture* build_grid_texture(const App* app, uint8_t a) {
+    SDL_Texture* tex = SDL_CreateTexture(app->renderer, SDL_PIXELFORMAT_RGBA8888,
+                                         SDL_TEXTUREACCESS_TARGET,
+                                         app->window_w, app->window_h);
+    if (!tex) return NULL;
+
+    SDL_Texture* prev_target = SDL_GetRenderTarget(app->renderer);
+    if (!SDL_SetRenderTarget(app->renderer, tex)) {
+        SDL_DestroyTexture(tex);
+        return NULL;
+    }
+
+    SDL_SetRenderDrawBlendMode(app->renderer, SDL_BLENDMODE_NONE);
+    SDL_SetRenderDrawColor(app->renderer, 0, 0, 0, 0);
+    SDL_RenderClear(app->renderer);
+    draw_grid_lines(app, SDL_BLENDMODE_NONE, GRID_R, GRID_G, GRID_B, a);
+
+    SDL_SetRenderTarget(app->renderer, prev_target);
+
+    SDL_SetTextureBlendMode(tex, SDL_BLENDMODE_BLEND);
+    SDL_SetTextureScaleMode(tex, SDL_SCALEMODE_NEAREST);
+    return tex;
+}
+
+// Makes sure both grid textures match the current window/grid size.
+static bool ensure_grid_cache(App* app) {
+    if (app->grid_tex_failed) return false;
+
+    if (app->grid_tex && app->grid_tex_dim &&
+        app->grid_tex_w == app->window_w && app->grid_tex_h == app->window_h &&
+        app->grid_tex_cols == app->grid_w && app->grid_tex_rows == app->grid_h) {
+        return true;
+    }
+
+    Render_InvalidateGridCache(app);
+
+    app->grid_tex = build_grid_texture(app, GRID_A);
+    app->grid_tex_dim = build_grid_texture(app, GRID_DIM_A);
+    if (!app->grid_tex || !app->grid_tex_dim) {
+        SDL_Log("Grid texture cache unavailable (drawing lines directly): %s",
+                SDL_GetError());
+        Render_InvalidateGridCache(app);
+        app->grid_tex_failed = true;
+        return false;
+    }
+
+    app->grid_tex_w = app->window_w;
+    app->grid_tex_h = app->window_h;
+    app->grid_tex_cols = app->grid_w;
+    app->grid_tex_rows = app->grid_h;
+    return true;
+}
+
+static void blit_grid(App* app, bool dimmed) {
+    if (!app || !app->renderer) return;
+
+    if (!ensure_grid_cache(app)) {
+        Render_GridLinesEx(app, GRID_R, GRID_G, GRID_B, dimmed ? GRID_DIM_A : GRID_A);
+        return;
+    }
+
+    SDL_RenderTexture(app->renderer, dimmed ? app->grid_tex_dim : app->grid_tex, NULL, NULL);
+}
+
+void Render_GridLines(App* app) {
     // original look
-    Render_GridLinesEx(app, 40, 40, 40, 255);
+    blit_grid(app, false);
+}
+
+void Render_GridLinesDimmed(App* app) {
+    blit_grid(app, true);
 }
@@ -0,0 +1,51 @@
+#include "render_batch.h"
+#include <stdlib.h>
+
+
+/*
+ * render_batch.c
+ * Grow-only rect batch submitted through SDL_RenderFillRects.
+ */
+
+
+#define RENDER_BATCH_MIN_CAP 256
+
+void RenderBatch_Reset(RenderBatch* b) {
+    if (!b) return;
+    b->count = 0;
+}
+
+void RenderBatch_Rect(RenderBatch* b, float x, float y, float w, float h) {
+    if (!b) return;
+
+    if (b->count >= b->cap) {
+        int new_cap = (b->cap > 0) ? b->cap * 2 : RENDER_BATCH_MIN_CAP;
+        SDL_FRect* grown = (SDL_FRect*)realloc(b->rects, (size_t)new_cap * sizeof(*grown));
+        if (!grown) return;
+        b->rects = grown;
+        b->cap = new_cap;
+        b->heap_allocs++;
+    }
+
+    SDL_FRect* rect = &b->rects[b->count++];
+    rect->x = x;
+    rect->y = y;
+    rect->w = w;
+    rect->h = h;
+}
+
+void RenderBatch_FillRange(SDL_Renderer* r, const RenderBatch* b, int first, int count,
+                           uint8_t cr, uint8_t cg, uint8_t cb) {
+    if (!r || !b || count <= 0 || first < 0 || first + count > b->count) return;
+
+    SDL_SetRenderDrawColor(r, cr, cg, cb, 255);
+    SDL_RenderFillRects(r, b->rects + first, count);
+}
+
+void RenderBatch_Destroy(RenderBatch* b) {
+    if (!b) return;
+    free(b->rects);
+    b->rects = NULL;
+    b->count = 0;
+    b->cap = 0;
+}
@@ -0,0 +1,238 @@
+#include <SDL3/SDL.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "apple.h"
+#include "bot.h"
+#include "cycle_file.h"
+#include "snake.h"
+
+/*
+ * sim.c
+ * Headless bot simulation (snake_sim target).
+ *
+ * Runs the same per-tick sequence as the game loop in main.c
+ * (Bot_OnTick -> Snake_Tick -> Apple_TryEatAndRespawn -> self-hit check)
+ * without a window, renderer, audio or frame cap, and reports throughput and
+ * win statistics. Only SDL's core helpers (SDL_rand, SDL_GetTicksNS) are used,
+ * so SDL_Init is never called and no display is required.
+ */
+
+#define SIM_GRID_W 40
+#define SIM_GRID_H 30
+#define SIM_GAMES 10
+
+typedef enum GameResult { GAME_WIN, GAME_DEATH, GAME_STALLED } GameResult;
+
+static bool arg_eq(const char *a, const char *b) {
+  return a && b && strcmp(a, b) == 0;
+}
+
+static void print_usage(const char *exe) {
+  fprintf(stderr,
+          "usage: %s [--grid-w N] [--grid-h N] [--bot-cycle FILE]\n"
+          "          [--seed N] [--games N] [--max-game-ticks N]\n"
+          "          [--bot-preset NAME] [--bot-k-* VALUE ...]\n"
+          "          [--bot-mode cycle|plan|repair] [--bot-plan-budget-us N]\n"
+          "          [--bot-tick-budget-us N] [--bot-lookahead DEPTH]\n",
+          exe);
+}
+
+// Plays one game to completion. Mirrors the fixed-step body of main.c.
+static GameResult play_game(Bot *bot, Snake *snake, int grid_w, int grid_h,
+                            uint64_t max_ticks, uint64_t *out_ticks) {
+  Snake_Destroy(snake);
+  Dir start_dir = (Dir)SDL_rand(4);
+  if (!Snake_Init(snake, grid_w, grid_h, grid_w * grid_h, start_dir)) {
+    *out_ticks = 0;
+    return GAME_STALLED;
+  }
+
+  Apple apple;
+  Apple_Init(&apple, snake);
+  Bot_Reset(bot);
+
+  const int max_score = snake->max_len - 1;
+  int score = 0;
+  uint64_t ticks = 0;
+  GameResult result = GAME_STALLED;
+
+  while (ticks < max_ticks) {
+    Bot_OnTick(bot, snake, &apple);
+    Snake_Tick(snake);
+    ticks++;
+
+    if (Apple_TryEatAndRespawn(&apple, snake)) {
+      score += 1;
+      if (score >= max_score) {
+        result = GAME_WIN;
+        break;
+      }
+    }
+
+    if (Snake_HitSelf(snake)) {
+      result = GAME_DEATH;
+      break;
+    }
+  }
+
+  *out_ticks = ticks;
+  return result;
+}
+
+int main(int argc, char **argv) {
+  int grid_w = SIM_GRID_W;
+  int grid_h = SIM_GRID_H;
+  const char *cycle_path = NULL;
+  unsigned int seed = 1;
+  int games = SIM_GAMES;
+  uint64_t max_game_ticks = 0;
+  BotTuning tuning = {0};
+  apply_preset(PRESET_SAFE, &tuning);
+
+  for (int i = 1; i < argc; i++) {
+    int tuning_used = parse_tuning_arg(argc, argv, i, &tuning);
+    if (tuning_used < 0) {
+      fprintf(stderr, "Invalid value for %s: %s\n", argv[i], argv[i + 1]);
+      return 1;
+    }
+    if (tuning_used > 0) {
+      i += tuning_used;
+    } else if (arg_eq(argv[i], "--grid-w") && i + 1 < argc) {
+      grid_w = atoi(argv[++i]);
+    } else if (arg_eq(argv[i], "--grid-h") && i + 1 < argc) {
+      grid_h = atoi(argv[++i]);
+    } else if (arg_eq(argv[i], "--bot-cycle") && i + 1 < argc) {
+      cycle_path = argv[++i];
+    } else if (arg_eq(argv[i], "--seed") && i + 1 < argc) {
+      seed = (unsigned int)strtoul(argv[++i], NULL, 10);
+    } else if (arg_eq(argv[i], "--games") && i + 1 < argc) {
+      games = atoi(argv[++i]);
+    } else if (arg_eq(argv[i], "--max-game-ticks") && i + 1 < argc) {
+      max_game_ticks = strtoull(argv[++i], NULL, 10);
+    } else {
+      print_usage(argv[0]);
+      return 1;
+    }
+  }
+
+  // A cycle file carries its own board size, which overrides --grid-w/h.
+  CycleFile cycle = {0};
+  if (cycle_path) {
+    char err[256];
+    if (!CycleFile_Load(&cycle, cycle_path, err, (int)sizeof(err))) {
+      fprintf(stderr, "Bot cycle load failed (%s): %s\n", cycle_path, err);
+      return 1;
+    }
+    grid_w = cycle.meta.width;
+    grid_h = cycle.meta.height;
+  }
+
+  if (grid_w < 2 || grid_h < 2 || games <= 0) {
+    CycleFile_Free(&cycle);
+    print_usage(argv[0]);
+    return 1;
+  }
+
+  const uint64_t n_cells = (uint64_t)grid_w * (uint64_t)grid_h;
+  // A bot that neither wins nor dies is stuck in a loop; give up on that game
+  // well past the worst case for a pure cycle follower (~n^2 / 2 ticks).
+  if (max_game_ticks == 0)
+    max_game_ticks = n_cells * n_cells;
+
+  SDL_srand((Uint64)seed);
+
+  Bot bot = {0};
+  if (cycle_path) {
+    bool ok = Bot_InitFromCycle(&bot, &cycle);
+    CycleFile_Free(&cycle);
+    if (!ok) {
+      fprintf(stderr, "Bot cycle load failed (%s).\n", cycle_path);
+      return 1;
+    }
+  } else if (!Bot_Init(&bot, grid_w, grid_h)) {
+    fprintf(stderr, "Bot_Init failed for %dx%d (built-in cycle needs even "
+                    "w/h >= 4; pass --bot-cycle otherwise).\n",
+            grid_w, grid_h);
+    return 1;
+  }
+  Bot_SetTuning(&bot, &tuning);
+
+  Snake snake = {0};
+  int wins = 0;
+  int deaths = 0;
+  int stalled = 0;
+  uint64_t total_ticks = 0;
+  uint64_t win_ticks = 0;
+
+  const uint64_t start_ns = SDL_GetTicksNS();
+  for (int g = 0; g < games; g++) {
+    uint64_t ticks = 0;
+    GameResult r = play_game(&bot, &snake, grid_w, grid_h, max_game_ticks,
+                             &ticks);
+    total_ticks += ticks;
+    if (r == GAME_WIN) {
+      wins++;
+      win_ticks += ticks;
+    } else if (r == GAME_DEATH) {
+      deaths++;
+    } else {
+      stalled++;
+    }
+  }
+  const uint64_t elapsed_ns = SDL_GetTicksNS() - start_ns;
+  const uint64_t plan_paths = bot.plan.n_paths;
+  const uint64_t plan_chase = bot.plan.n_chase;
+  const uint64_t plan_failed = bot.plan.n_failed;
+  const uint64_t repairs = bot.n_repairs;
+  const uint64_t decisions = bot.n_decisions;
+  const uint64_t decide_ns_total = bot.decide_ns_total;
+  const uint64_t decide_ns_max = bot.decide_ns_max;
+  const uint64_t decide_ns_p50 = Histogram_Percentile(&bot.decide_time, 0.50);
+  const uint64_t decide_ns_p99 = Histogram_Percentile(&bot.decide_time, 0.99);
+  const uint64_t lookaheads = bot.n_lookahead;
+  const uint64_t depth_sum = bot.lookahead_depth_sum;
+  const uint64_t exhausted = bot.n_budget_exhausted;
+
+  Snake_Destroy(&snake);
+  Bot_Destroy(&bot);
+
+  double secs = (double)elapsed_ns / 1e9;
+  printf("grid: %dx%d  seed: %u  cycle: %s\n", grid_w, grid_h, seed,
+         cycle_path ? cycle_path : "(built-in serpentine)");
+  printf("games completed: %d (wins %d, deaths %d, stalled %d)\n",
+         wins + deaths, wins, deaths, stalled);
+  printf("total ticks: %llu in %.3f s\n", (unsigned long long)total_ticks,
+         secs);
+  printf("ticks/sec: %.0f\n", (secs > 0.0) ? (double)total_ticks / secs : 0.0);
+  if (wins > 0) {
+    printf("avg ticks-to-win: %.1f\n", (double)win_ticks / (double)wins);
+  } else {
+    printf("avg ticks-to-win: n/a\n");
+  }
+  if (tuning.mode == BOT_MODE_PLAN) {
+    printf("planner: %llu paths, %llu tail-chase moves, %llu fell back\n",
+           (unsigned long long)plan_paths, (unsigned long long)plan_chase,
+           (unsigned long long)plan_failed);
+  } else if (tuning.mode == BOT_MODE_REPAIR) {
+    printf("cycle repairs: %llu\n", (unsigned long long)repairs);
+  }
+  if (tuning.tick_budget_us > 0 && decisions > 0) {
+    printf("bot decision: avg %.2f us, p50 %.2f us, p99 %.2f us, max %.2f us "
+           "(budget %d us)\n",
+           (double)decide_ns_total / (double)decisions / 1000.0,
+           (double)decide_ns_p50 / 1000.0, (double)decide_ns_p99 / 1000.0,
+           (double)decide_ns_max / 1000.0, tuning.tick_budget_us);
+    printf("lookahead: %llu ticks, avg depth %.2f, budget exhausted %llu "
+           "(%.2f%%)\n",
+           (unsigned long long)lookaheads,
+           lookaheads ? (double)depth_sum / (double)lookaheads : 0.0,
+           (unsigned long long)exhausted,
+           lookaheads ? 100.0 * (double)exhausted / (double)lookaheads : 0.0);
+  }
+
+  return (deaths > 0 || stalled > 0) ? 2 : 0;
+}
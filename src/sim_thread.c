@@ -0,0 +1,326 @@
+#include "sim_thread.h"
+#include <stdlib.h>
+#include <string.h>
+
+
+/*
+ * sim_thread.c
+ * Fixed-step simulation thread and the snapshot triple buffer.
+ *
+ * The thread keeps its own tick clock: due ticks run in budgeted batches
+ * (see sim_thread.h), then it sleeps until the next one is due (or
+ * SIM_POLL_NS, whichever is sooner, so continue / quit are seen promptly at
+ * low tick rates). At max speed it never sleeps.
+ */
+
+
+#define BASE_TICK_HZ 7
+#define RAMP_EVERY 3
+#define MAX_TICK_HZ 20
+
+// Longest sleep between checks for continue / quit.
+#define SIM_POLL_NS 1000000ull
+
+// Copying a snapshot out is O(len). While the reader has not taken the last
+// one, newer ticks only replace it this often.
+#define SIM_REPUBLISH_NS 1000000ull
+
+#define SIM_SNAPSHOT_FRESH 4
+
+
+static uint64_t ns_from_hz(int hz) {
+    return (hz > 0) ? (1000000000ull / (uint64_t)hz) : 0;
+}
+
+static int tick_hz_for_score(int score) {
+    int hz = BASE_TICK_HZ + (score / RAMP_EVERY);
+    if (hz < 1) return 1;
+    if (hz > MAX_TICK_HZ) return MAX_TICK_HZ;
+    return hz;
+}
+
+static void set_tick_rate(SimThread* st) {
+    st->tick_hz = st->bot ? st->bot_tps : tick_hz_for_score(st->score);
+    st->tick_ns = ns_from_hz(st->tick_hz);
+}
+
+static bool new_game(SimThread* st) {
+    Snake_Destroy(&st->snake);
+
+    Dir start_dir = (Dir)SDL_rand(4);
+    if (!Snake_Init(&st->snake, st->grid_w, st->grid_h,
+                    st->grid_w * st->grid_h, start_dir)) {
+        return false;
+    }
+
+    st->score = st->snake.len - 1;
+    if (st->score < 0) st->score = 0;
+    st->max_score = st->snake.max_len - 1;
+
+    Apple_Init(&st->apple, &st->snake);
+    if (st->bot) Bot_Reset(st->bot);
+
+    set_tick_rate(st);
+    st->tick_time_ns = SDL_GetTicksNS();
+    st->game_over = false;
+    st->you_win = false;
+    st->game++;
+    return true;
+}
+
+// Segments 0..len in order (the last one is where the tail was a tick ago),
+// so the copy is a ring buffer with head 0 and cap len + 1.
+static void write_snapshot(const SimThread* st, SimSnapshot* out) {
+    const Snake* s = &st->snake;
+    const int n = s->len + 1;
+    int first = s->cap - s->head;
+    if (first > n) first = n;
+    memcpy(out->body, s->seg + s->head, (size_t)first * sizeof(IVec2));
+    memcpy(out->body + first, s->seg, (size_t)(n - first) * sizeof(IVec2));
+
+    out->snake = *s;
+    out->snake.seg = out->body;
+    out->snake.cap = n;
+    out->snake.head = 0;
+    out->snake.occ = NULL;
+    out->snake.free_cells = NULL;
+    out->snake.free_pos = NULL;
+
+    out->apple = st->apple;
+    out->score = st->score;
+    out->tick_hz = st->tick_hz;
+    out->game_over = st->game_over;
+    out->you_win = st->you_win;
+    out->game = st->game;
+    out->tick_time_ns = st->tick_time_ns;
+    out->tick_ns = st->tick_ns;
+}
+
+static void publish(SimThread* st, uint64_t now) {
+    write_snapshot(st, &st->slots[st->back]);
+    int prev = SDL_SetAtomicInt(&st->middle, st->back | SIM_SNAPSHOT_FRESH);
+    st->back = prev & ~SIM_SNAPSHOT_FRESH;
+    st->last_publish_ns = now;
+}
+
+static bool publish_due(SimThread* st, uint64_t now) {
+    if (!(SDL_GetAtomicInt(&st->middle) & SIM_SNAPSHOT_FRESH)) return true;
+    return now - st->last_publish_ns >= SIM_REPUBLISH_NS;
+}
+
+// The per-tick sequence of the old single-threaded loop: bot, move, eat,
+// self-hit.
+static void sim_tick(SimThread* st) {
+    if (st->bot) {
+        Bot_OnTick(st->bot, &st->snake, &st->apple);
+    }
+    Snake_Tick(&st->snake);
+    SDL_AddAtomicInt(&st->ticks, 1);
+
+    if (Apple_TryEatAndRespawn(&st->apple, &st->snake)) {
+        st->score += 1;
+
+        if (st->score >= st->max_score) {
+            // Freeze the final pose so the win screen stays still.
+            Snake_ForceWinFill(&st->snake);
+            Snake_SyncPrev(&st->snake);
+            st->you_win = true;
+            return;
+        }
+        // Difficulty ramp (human play): later ticks use the new rate.
+        set_tick_rate(st);
+    }
+
+    if (Snake_HitSelf(&st->snake)) {
+        st->game_over = true;
+    }
+}
+
+static void record_tick_cost(SimThread* st, uint64_t cost) {
+    SimTickStats* ts = &st->stats;
+    ts->ticks++;
+    ts->tick_ns_total += cost;
+    if (cost > ts->tick_ns_max) ts->tick_ns_max = cost;
+    Histogram_Record(&ts->tick_time, cost);
+    // Average over roughly the last 16 ticks.
+    st->tick_cost_ns = st->tick_cost_ns - st->tick_cost_ns / 16 + cost / 16;
+}
+
+static bool pop_input(SimThread* st, Dir* out) {
+    int head = SDL_GetAtomicInt(&st->input_head);
+    if (head == SDL_GetAtomicInt(&st->input_tail)) return false;
+    *out = st->input[head & (SIM_INPUT_CAP - 1)];
+    SDL_SetAtomicInt(&st->input_head, head + 1);
+    return true;
+}
+
+static int sim_main(void* userdata) {
+    SimThread* st = (SimThread*)userdata;
+    uint64_t next = SDL_GetTicksNS() + st->tick_ns;
+    bool pending = false;   // ticks run since the last publish
+
+    while (!SDL_GetAtomicInt(&st->quit)) {
+        uint64_t now = SDL_GetTicksNS();
+
+        if (SDL_SetAtomicInt(&st->continue_req, 0) &&
+            (st->game_over || st->you_win)) {
+            if (!new_game(st)) {
+                SDL_Log("Snake_Init failed; stopping the simulation.");
+                break;
+            }
+            now = SDL_GetTicksNS();
+            next = now + st->tick_ns;
+            publish(st, now);
+            pending = false;
+        }
+
+        if (st->game_over || st->you_win) {
+            SDL_DelayNS(SIM_POLL_NS);
+            continue;
+        }
+
+        Dir d;
+        while (pop_input(st, &d)) {
+            Snake_QueueDir(&st->snake, d);
+        }
+
+        if (st->tick_ns == 0) {
+            next = now;
+        } else if (now > next + SIM_MAX_LAG_NS) {
+            uint64_t behind = now - next;
+            uint64_t dropped = behind / st->tick_ns;
+            st->stats.dropped += dropped;
+            SDL_Log("Simulation fell %.0f ms behind; dropped %llu ticks.",
+                    (double)behind / 1e6, (unsigned long long)dropped);
+            next = now;
+        }
+
+        // One batch: due ticks while the next one is expected to fit.
+        const uint64_t batch_end = now + st->batch_budget_ns;
+        uint64_t ran = 0;
+        while (now >= next && !st->game_over && !st->you_win) {
+            if (ran > 0 && now + st->tick_cost_ns > batch_end) {
+                if (st->tick_ns > 0) {
+                    st->stats.deferred += (now - next) / st->tick_ns + 1;
+                }
+                break;
+            }
+
+            st->tick_time_ns = next;
+            sim_tick(st);
+            uint64_t after = SDL_GetTicksNS();
+            record_tick_cost(st, after - now);
+            next = (st->tick_ns > 0) ? next + st->tick_ns : after;
+            now = after;
+            ran++;
+            pending = true;
+
+            if (publish_due(st, now)) {
+                publish(st, now);
+                pending = false;
+                now = SDL_GetTicksNS();
+            }
+        }
+        if (ran > 0) {
+            st->stats.batches++;
+            if (ran > st->stats.max_batch) st->stats.max_batch = ran;
+        }
+
+        // Don't leave a tick unpublished across a long sleep or an end state.
+        uint64_t wait = (next > now) ? next - now : 0;
+        bool ended = st->game_over || st->you_win;
+        if (pending && (ended || wait >= SIM_REPUBLISH_NS)) {
+            publish(st, now);
+            pending = false;
+        }
+
+        if (wait > SIM_POLL_NS) wait = SIM_POLL_NS;
+        if (wait > 0) SDL_DelayNS(wait);
+    }
+    return 0;
+}
+
+bool SimThread_Init(SimThread* st, int grid_w, int grid_h, Bot* bot, int bot_tps) {
+    if (!st || grid_w < 2 || grid_h < 2) return false;
+    memset(st, 0, sizeof(*st));
+
+    st->bot = bot;
+    st->bot_tps = bot_tps;
+    st->grid_w = grid_w;
+    st->grid_h = grid_h;
+    st->batch_budget_ns = SIM_BATCH_BUDGET_NS;
+
+    const size_t body_len = (size_t)grid_w * (size_t)grid_h + 1;
+    for (int i = 0; i < 3; i++) {
+        st->slots[i].body = (IVec2*)malloc(body_len * sizeof(IVec2));
+        if (!st->slots[i].body) {
+            SimThread_Destroy(st);
+            return false;
+        }
+    }
+
+    if (!new_game(st)) {
+        SimThread_Destroy(st);
+        return false;
+    }
+
+    // Reader starts on slot 0, the middle slot 1 holds the same first
+    // snapshot, and the writer fills slot 2 next.
+    st->front = 0;
+    st->back = 2;
+    write_snapshot(st, &st->slots[0]);
+    write_snapshot(st, &st->slots[1]);
+    SDL_SetAtomicInt(&st->middle, 1);
+    st->last_publish_ns = SDL_GetTicksNS();
+    return true;
+}
+
+bool SimThread_Start(SimThread* st) {
+    if (!st || st->thread) return false;
+    SDL_SetAtomicInt(&st->quit, 0);
+    st->thread = SDL_CreateThread(sim_main, "sim", st);
+    if (!st->thread) {
+        SDL_Log("SDL_CreateThread failed: %s", SDL_GetError());
+        return false;
+    }
+    return true;
+}
+
+void SimThread_Stop(SimThread* st) {
+    if (!st || !st->thread) return;
+    SDL_SetAtomicInt(&st->quit, 1);
+    SDL_WaitThread(st->thread, NULL);
+    st->thread = NULL;
+}
+
+void SimThread_Destroy(SimThread* st) {
+    if (!st) return;
+    for (int i = 0; i < 3; i++) {
+        free(st->slots[i].body);
+        st->slots[i].body = NULL;
+    }
+    Snake_Destroy(&st->snake);
+}
+
+const SimSnapshot* SimThread_Latest(SimThread* st) {
+    if (SDL_GetAtomicInt(&st->middle) & SIM_SNAPSHOT_FRESH) {
+        int prev = SDL_SetAtomicInt(&st->middle, st->front);
+        st->front = prev & ~SIM_SNAPSHOT_FRESH;
+    }
+    return &st->slots[st->front];
+}
+
+void SimThread_QueueDir(SimThread* st, Dir d) {
+    int tail = SDL_GetAtomicInt(&st->input_tail);
+    if (tail - SDL_GetAtomicInt(&st->input_head) >= SIM_INPUT_CAP) return;
+    st->input[tail & (SIM_INPUT_CAP - 1)] = d;
+    SDL_SetAtomicInt(&st->input_tail, tail + 1);
+}
+
+void SimThread_RequestContinue(SimThread* st) {
+    SDL_SetAtomicInt(&st->continue_req, 1);
+}
+
+int SimThread_TakeTicks(SimThread* st) {
+    return SDL_SetAtomicInt(&st->ticks, 0);
+}
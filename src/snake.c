@@ -25,6 +25,34 @@ static IVec2 wrap_pos(int w, int h, IVec2 p) {
     return p;
 }
 
+static inline int cell_of(const Snake* s, IVec2 p) {
+    return p.y * s->grid_w + p.x;
+}
+
+// Free-cell set maintenance (swap-remove keeps it dense).
+static void free_remove(Snake* s, int cell) {
+    int k = s->free_pos[cell];
+    int last = s->free_cells[--s->free_count];
+    s->free_cells[k] = last;
+    s->free_pos[last] = k;
+    s->free_pos[cell] = -1;
+}
+
+static void free_add(Snake* s, int cell) {
+    s->free_cells[s->free_count] = cell;
+    s->free_pos[cell] = s->free_count++;
+}
+
+static inline void occ_inc(Snake* s, IVec2 p) {
+    int cell = cell_of(s, p);
+    if (s->occ[cell]++ == 0) free_remove(s, cell);
+}
+
+static inline void occ_dec(Snake* s, IVec2 p) {
+    int cell = cell_of(s, p);
+    if (--s->occ[cell] == 0) free_add(s, cell);
+}
+
 static IVec2 step_dir(IVec2 p, Dir d) {
     switch (d) {
         case DIR_UP:    p.y -= 1; break;
@@ -42,17 +70,28 @@ bool Snake_Init(Snake* s, int grid_w, int grid_h, int max_len, Dir start_dir) {
     s->grid_h = grid_h;
     s->max_len = max_len;
 
-    s->seg = (IVec2*)calloc((size_t)max_len, sizeof(IVec2));
-    s->prev = (IVec2*)calloc((size_t)max_len, sizeof(IVec2));
-    if (!s->seg || !s->prev) {
-        free(s->seg);
-        free(s->prev);
-        s->seg = s->prev = NULL;
+    // One spare slot so last tick's tail survives as the tail's prev.
+    const int n_cells = grid_w * grid_h;
+    s->cap = max_len + 1;
+    s->seg = (IVec2*)calloc((size_t)s->cap, sizeof(IVec2));
+    s->occ = (uint16_t*)calloc((size_t)n_cells, sizeof(uint16_t));
+    s->free_cells = (int*)malloc((size_t)n_cells * sizeof(int));
+    s->free_pos = (int*)malloc((size_t)n_cells * sizeof(int));
+    if (!s->seg || !s->occ || !s->free_cells || !s->free_pos) {
+        Snake_Destroy(s);
         return false;
     }
 
+    for (int i = 0; i < n_cells; i++) {
+        s->free_cells[i] = i;
+        s->free_pos[i] = i;
+    }
+    s->free_count = n_cells;
+
     s->len = 1;
     s->grow = 0;
+    s->head = 0;
+    s->prev_len = 0;
 
     s->dir = start_dir;
     s->has_q1 = false;
@@ -61,7 +100,7 @@ bool Snake_Init(Snake* s, int grid_w, int grid_h, int max_len, Dir start_dir) {
     // start centered
     s->seg[0].x = grid_w / 2;
     s->seg[0].y = grid_h / 2;
-    s->prev[0] = s->seg[0];
+    occ_inc(s, s->seg[0]);
 
     return true;
 }
@@ -69,21 +108,43 @@ bool Snake_Init(Snake* s, int grid_w, int grid_h, int max_len, Dir start_dir) {
 void Snake_Destroy(Snake* s) {
     if (!s) return;
     free(s->seg);
-    free(s->prev);
-    s->seg = s->prev = NULL;
-    s->len = s->max_len = 0;
+    free(s->occ);
+    free(s->free_cells);
+    free(s->free_pos);
+    s->seg = NULL;
+    s->occ = NULL;
+    s->free_cells = NULL;
+    s->free_pos = NULL;
+    s->free_count = 0;
+    s->len = s->max_len = s->cap = 0;
+    s->head = s->prev_len = 0;
 }
 
-IVec2 Snake_Head(const Snake* s) {
-    return s->seg[0];
+void Snake_SyncPrev(Snake* s) {
+    if (!s) return;
+    s->prev_len = 0;
 }
 
-bool Snake_Occupies(const Snake* s, IVec2 p) {
-    if (!s) return false;
-    for (int i = 0; i < s->len; i++) {
-        if (s->seg[i].x == p.x && s->seg[i].y == p.y) return true;
+void Snake_ForceWinFill(Snake* s) {
+    if (!s) return;
+    while (s->grow > 0 && s->len < s->max_len) {
+        IVec2 tail_prev = Snake_Prev(s, s->len - 1);
+        s->seg[Snake_RingSlot(s, s->len)] = tail_prev;
+        occ_inc(s, tail_prev);
+        s->len += 1;
+        s->grow -= 1;
     }
-    return false;
+}
+
+bool Snake_Occupies(const Snake* s, IVec2 p) {
+    if (!s || !s->occ) return false;
+    if (p.x < 0 || p.x >= s->grid_w || p.y < 0 || p.y >= s->grid_h) return false;
+    return s->occ[cell_of(s, p)] != 0;
+}
+
+bool Snake_HitSelf(const Snake* s) {
+    if (!s || s->len <= 1) return false;
+    return s->occ[cell_of(s, Snake_Head(s))] > 1;
 }
 
 void Snake_AddGrowth(Snake* s, int n) {
@@ -124,18 +185,17 @@ void Snake_QueueDir(Snake* s, Dir d) {
  * Advance the simulation by one tick.
  *
  * Order matters for consistency and interpolation:
- * 1) Copy current positions into prev.
- * 2) Apply at most one buffered turn.
- * 3) Shift the body, step the head (with wrap), then apply one unit of growth.
+ * 1) Apply at most one buffered turn.
+ * 2) Push the new head (with wrap) into the slot before the old head. Every
+ *    old position stays in place and becomes the next segment's prev.
+ * 3) Keep the old tail as one unit of growth, otherwise it falls off the end.
+ * Occupancy counts (and the free-cell set) follow the same two deltas: tail
+ * pop first, then head push, so moving into the cell the tail just left is not
+ * a collision.
  */
 void Snake_Tick(Snake* s) {
     if (!s) return;
 
-    // Save previous positions for interpolation (only active length)
-    for (int i = 0; i < s->len; i++) {
-        s->prev[i] = s->seg[i];
-    }
-
     // Apply at most one buffered turn
     if (s->has_q1) {
         s->dir = s->q1;
@@ -148,23 +208,24 @@ void Snake_Tick(Snake* s) {
         }
     }
 
-    // Remember tail before shifting (used if we grow)
-    IVec2 old_tail = s->seg[s->len - 1];
+    IVec2 new_head = step_dir(Snake_Head(s), s->dir);
+    new_head = wrap_pos(s->grid_w, s->grid_h, new_head);
 
-    // Shift body back
-    for (int i = s->len - 1; i >= 1; i--) {
-        s->seg[i] = s->seg[i - 1];
+    bool grows = (s->grow > 0 && s->len < s->max_len);
+    if (!grows) {
+        occ_dec(s, Snake_Tail(s));
     }
 
-    // Move head one cell
-    IVec2 new_head = step_dir(s->seg[0], s->dir);
-    new_head = wrap_pos(s->grid_w, s->grid_h, new_head);
-    s->seg[0] = new_head;
+    // Segments that existed before this tick get a shifted prev.
+    s->prev_len = s->len;
+
+    // len < cap, so the new head slot never overwrites the old tail slot.
+    s->head = (s->head == 0) ? (s->cap - 1) : (s->head - 1);
+    s->seg[s->head] = new_head;
+    occ_inc(s, new_head);
 
-    // Growth: keep old tail as new segment
-    if (s->grow > 0 && s->len < s->max_len) {
-        s->seg[s->len] = old_tail;
-        s->prev[s->len] = old_tail; // initialize prev for new segment
+    // Growth: the old tail is now at index len and simply stays in the body.
+    if (grows) {
         s->len += 1;
         s->grow -= 1;
     }
@@ -7,6 +7,8 @@
 /*
  * snake_draw.c
  * Snake rendering with interpolation + wrap-aware bridging.
+ * All rects go through App's RenderBatch: three SDL_RenderFillRects calls per
+ * frame regardless of snake length.
  */
 
 
@@ -55,9 +57,9 @@ static FVec2 nearest_wrapped_px(const App* app, FVec2 a, FVec2 b) {
     return b;
 }
 
-// Draw a filled rect that wraps around screen edges (splits if needed).
-static void draw_wrapped_rect(const App* app, float x, float y, float w, float h,
-                              uint8_t r, uint8_t g, uint8_t b) {
+// Queue a filled rect that wraps around screen edges (splits if needed).
+static void draw_wrapped_rect(const App* app, RenderBatch* batch,
+                              float x, float y, float w, float h) {
     float W = (float)app->window_w;
     float H = (float)app->window_h;
 
@@ -70,35 +72,35 @@ static void draw_wrapped_rect(const App* app, float x, float y, float w, float h
     // Split horizontally if needed
     if (x < 0.0f) {
         float left_w = -x;
-        Render_RectFilledPx(app, 0.0f, y, w - left_w, h, r, g, b);
-        Render_RectFilledPx(app, W - left_w, y, left_w, h, r, g, b);
+        RenderBatch_Rect(batch, 0.0f, y, w - left_w, h);
+        RenderBatch_Rect(batch, W - left_w, y, left_w, h);
         return;
     }
     if (x + w > W) {
         float right_w = (x + w) - W;
-        Render_RectFilledPx(app, x, y, w - right_w, h, r, g, b);
-        Render_RectFilledPx(app, 0.0f, y, right_w, h, r, g, b);
+        RenderBatch_Rect(batch, x, y, w - right_w, h);
+        RenderBatch_Rect(batch, 0.0f, y, right_w, h);
         return;
     }
 
     // Split vertically if needed
     if (y < 0.0f) {
         float top_h = -y;
-        Render_RectFilledPx(app, x, 0.0f, w, h - top_h, r, g, b);
-        Render_RectFilledPx(app, x, H - top_h, w, top_h, r, g, b);
+        RenderBatch_Rect(batch, x, 0.0f, w, h - top_h);
+        RenderBatch_Rect(batch, x, H - top_h, w, top_h);
         return;
     }
     if (y + h > H) {
         float bot_h = (y + h) - H;
-        Render_RectFilledPx(app, x, y, w, h - bot_h, r, g, b);
-        Render_RectFilledPx(app, x, 0.0f, w, bot_h, r, g, b);
+        RenderBatch_Rect(batch, x, y, w, h - bot_h);
+        RenderBatch_Rect(batch, x, 0.0f, w, bot_h);
         return;
     }
 
-    Render_RectFilledPx(app, x, y, w, h, r, g, b);
+    RenderBatch_Rect(batch, x, y, w, h);
 }
 
-static void draw_h_bridge(const App* app, FVec2 a, FVec2 b, uint8_t r, uint8_t g, uint8_t bl) {
+static void draw_h_bridge(const App* app, RenderBatch* batch, FVec2 a, FVec2 b) {
     float cw = (float)app->cell_w;
     float ch = (float)app->cell_h;
 
@@ -111,10 +113,10 @@ static void draw_h_bridge(const App* app, FVec2 a, FVec2 b, uint8_t r, uint8_t g
     float y = a.y - ch * 0.5f;
     float h = ch;
 
-    draw_wrapped_rect(app, x, y, w, h, r, g, bl);
+    draw_wrapped_rect(app, batch, x, y, w, h);
 }
 
-static void draw_v_bridge(const App* app, FVec2 a, FVec2 b, uint8_t r, uint8_t g, uint8_t bl) {
+static void draw_v_bridge(const App* app, RenderBatch* batch, FVec2 a, FVec2 b) {
     float cw = (float)app->cell_w;
     float ch = (float)app->cell_h;
 
@@ -127,7 +129,7 @@ static void draw_v_bridge(const App* app, FVec2 a, FVec2 b, uint8_t r, uint8_t g
     float x = a.x - cw * 0.5f;
     float w = cw;
 
-    draw_wrapped_rect(app, x, y, w, h, r, g, bl);
+    draw_wrapped_rect(app, batch, x, y, w, h);
 }
 
 // Wrap-aware integer delta between two grid coords (expects step of -1/0/1).
@@ -138,37 +140,37 @@ static int wrap_delta_i(int prev, int curr, int size) {
     return d;
 }
 
-// Draw an L-shaped bridge between centers using the correct elbow.
+// Queue an L-shaped bridge between centers using the correct elbow.
 // horiz_first determines which leg is drawn first at corners.
-static void draw_bridge_L(const App* app, FVec2 c0, FVec2 c1, bool horiz_first,
-                          uint8_t r, uint8_t g, uint8_t bl) {
+static void draw_bridge_L(const App* app, RenderBatch* batch, FVec2 c0, FVec2 c1,
+                          bool horiz_first) {
     c1 = nearest_wrapped_px(app, c0, c1);
 
     float dx = c1.x - c0.x;
     float dy = c1.y - c0.y;
 
     if (fabsf(dx) < 0.001f) {
-        draw_v_bridge(app, c0, c1, r, g, bl);
+        draw_v_bridge(app, batch, c0, c1);
         return;
     }
     if (fabsf(dy) < 0.001f) {
-        draw_h_bridge(app, c0, c1, r, g, bl);
+        draw_h_bridge(app, batch, c0, c1);
         return;
     }
 
     if (horiz_first) {
         FVec2 elbow = { c1.x, c0.y };
-        draw_h_bridge(app, c0, elbow, r, g, bl);
-        draw_v_bridge(app, elbow, c1, r, g, bl);
+        draw_h_bridge(app, batch, c0, elbow);
+        draw_v_bridge(app, batch, elbow, c1);
     } else {
         FVec2 elbow = { c0.x, c1.y };
-        draw_v_bridge(app, c0, elbow, r, g, bl);
-        draw_h_bridge(app, elbow, c1, r, g, bl);
+        draw_v_bridge(app, batch, c0, elbow);
+        draw_h_bridge(app, batch, elbow, c1);
     }
 }
 
-void SnakeDraw_Render(const App* app, const Snake* snake, float alpha, SnakeDrawStyle style) {
-    if (!app || !app->renderer || !snake || !snake->seg || !snake->prev) return;
+void SnakeDraw_Render(App* app, const Snake* snake, float alpha, SnakeDrawStyle style) {
+    if (!app || !app->renderer || !snake || !snake->seg) return;
     if (snake->len <= 0) return;
 
     alpha = clamp01f(alpha);
@@ -176,57 +178,73 @@ void SnakeDraw_Render(const App* app, const Snake* snake, float alpha, SnakeDraw
     int n = snake->len;
     if (n <= 0) return;
 
-    FVec2* centers_px = (FVec2*)malloc((size_t)n * sizeof(*centers_px));
+    FVec2* centers_px = (FVec2*)FrameArena_Alloc(&app->frame_arena, (size_t)n * sizeof(*centers_px));
     if (!centers_px) return;
 
 
     for (int i = 0; i < n; i++) {
         float gx, gy;
 
+        IVec2 seg = Snake_Seg(snake, i);
         if (i == 0 && style.snap_head) {
-            gx = (float)snake->seg[0].x;
-            gy = (float)snake->seg[0].y;
+            gx = (float)seg.x;
+            gy = (float)seg.y;
         } else {
-            gx = wrap_interp((float)snake->prev[i].x, (float)snake->seg[i].x, snake->grid_w, alpha);
-            gy = wrap_interp((float)snake->prev[i].y, (float)snake->seg[i].y, snake->grid_h, alpha);
+            IVec2 prev = Snake_Prev(snake, i);
+            gx = wrap_interp((float)prev.x, (float)seg.x, snake->grid_w, alpha);
+            gy = wrap_interp((float)prev.y, (float)seg.y, snake->grid_h, alpha);
         }
 
         centers_px[i] = grid_to_px_center(app, gx, gy);
     }
 
+    // Everything is queued into one batch and submitted as three color runs
+    // (bridges, head, body) so draw calls stay constant with snake length.
+    RenderBatch* batch = &app->rect_batch;
+    RenderBatch_Reset(batch);
+
+    const float cw = (float)app->cell_w;
+    const float ch = (float)app->cell_h;
+
     // Bridges first so segments sit on top and wrap seams look continuous.
     if (style.draw_bridges) {
         for (int i = 1; i < n; i++) {
-            int dx = wrap_delta_i(snake->prev[i - 1].x, snake->seg[i - 1].x, snake->grid_w);
-            int dy = wrap_delta_i(snake->prev[i - 1].y, snake->seg[i - 1].y, snake->grid_h);
+            IVec2 lead_prev = Snake_Prev(snake, i - 1);
+            IVec2 lead_seg = Snake_Seg(snake, i - 1);
+            int dx = wrap_delta_i(lead_prev.x, lead_seg.x, snake->grid_w);
+            int dy = wrap_delta_i(lead_prev.y, lead_seg.y, snake->grid_h);
             bool horiz_first = (dx != 0);
 
             if (dx == 0 && dy == 0) horiz_first = true;
 
-            draw_bridge_L(app, centers_px[i - 1], centers_px[i], horiz_first,
-                          style.body_r, style.body_g, style.body_b);
+            draw_bridge_L(app, batch, centers_px[i - 1], centers_px[i], horiz_first);
         }
     }
+    const int bridges_end = batch->count;
 
-    // ---- Draw head
+    // ---- Head
     if (style.snap_head) {
         // snapped head (classic look)
-        Render_CellFilled(app, snake->seg[0], style.head_r, style.head_g, style.head_b);
+        IVec2 head = Snake_Head(snake);
+        RenderBatch_Rect(batch, (float)(head.x * app->cell_w), (float)(head.y * app->cell_h),
+                         cw, ch);
     } else {
         // interpolated head (use computed pixel center like body)
-        float x = centers_px[0].x - (float)app->cell_w * 0.5f;
-        float y = centers_px[0].y - (float)app->cell_h * 0.5f;
-        Render_RectFilledPx(app, x, y, (float)app->cell_w, (float)app->cell_h,
-                            style.head_r, style.head_g, style.head_b);
+        RenderBatch_Rect(batch, centers_px[0].x - cw * 0.5f, centers_px[0].y - ch * 0.5f,
+                         cw, ch);
     }
+    const int head_end = batch->count;
 
-    // ---- Draw body squares at centers
+    // ---- Body squares at centers
     for (int i = 1; i < n; i++) {
-        float x = centers_px[i].x - (float)app->cell_w * 0.5f;
-        float y = centers_px[i].y - (float)app->cell_h * 0.5f;
-        Render_RectFilledPx(app, x, y, (float)app->cell_w, (float)app->cell_h,
-                            style.body_r, style.body_g, style.body_b);
+        RenderBatch_Rect(batch, centers_px[i].x - cw * 0.5f, centers_px[i].y - ch * 0.5f,
+                         cw, ch);
     }
 
-    free(centers_px);
+    RenderBatch_FillRange(app->renderer, batch, 0, bridges_end,
+                          style.body_r, style.body_g, style.body_b);
+    RenderBatch_FillRange(app->renderer, batch, bridges_end, head_end - bridges_end,
+                          style.head_r, style.head_g, style.head_b);
+    RenderBatch_FillRange(app->renderer, batch, head_end, batch->count - head_end,
+                          style.body_r, style.body_g, style.body_b);
 }